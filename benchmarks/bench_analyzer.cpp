@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include "AllocationCounter.hpp"
+#include "FrameArena.hpp"
+#include "HeartbeatAnalyzer.hpp"
+#include "bench_common.hpp"
+
+namespace {
+constexpr double kFps = 30.0;
+
+HeartbeatAnalyzer filled_analyzer(int window) {
+    HeartbeatAnalyzer analyzer(window, kFps);
+    for (const auto& s : bench::synthetic_trace(static_cast<size_t>(window), kFps)) {
+        analyzer.add_sample(s);
+    }
+    return analyzer;
+}
+} // namespace
+
+// Arg: window size in samples
+static void BM_AddSample(benchmark::State& state) {
+    const int window = static_cast<int>(state.range(0));
+    HeartbeatAnalyzer analyzer = filled_analyzer(window);
+    const auto trace = bench::synthetic_trace(1024, kFps);
+    size_t i = 0;
+    for (auto _ : state) {
+        analyzer.add_sample(trace[i++ & 1023]);
+    }
+}
+BENCHMARK(BM_AddSample)->RangeMultiplier(2)->Range(64, 1024);
+
+static void BM_CalculateBpm(benchmark::State& state) {
+    const int window = static_cast<int>(state.range(0));
+    const bool debug_capture = state.range(1) != 0;
+    HeartbeatAnalyzer analyzer = filled_analyzer(window);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(analyzer.calculate_bpm(45.0, 180.0, debug_capture));
+    }
+}
+BENCHMARK(BM_CalculateBpm)
+    ->ArgsProduct({benchmark::CreateRange(64, 1024, 2), {0, 1}})
+    ->ArgNames({"window", "debug"})
+    ->Unit(benchmark::kMicrosecond);
+
+// Scratch arrays from a FrameArena, reset per call as main does per frame. With
+// -DHBM_COUNT_ALLOCATIONS=ON, allocs_per_iter shows what still reaches operator new
+// (OpenCV's DFT plan and Mat headers unless the pooled Mat allocator is installed).
+static void BM_CalculateBpmArena(benchmark::State& state) {
+    const int window = static_cast<int>(state.range(0));
+    HeartbeatAnalyzer analyzer = filled_analyzer(window);
+    FrameArena arena;
+    (void)analyzer.calculate_bpm(45.0, 180.0, false, arena.resource()); // Let the arena settle
+    arena.reset();
+    const uint64_t allocations_before = alloc_counter::thread_count();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(analyzer.calculate_bpm(45.0, 180.0, false, arena.resource()));
+        arena.reset();
+    }
+    if constexpr (alloc_counter::kEnabled) {
+        state.counters["allocs_per_iter"] = benchmark::Counter(
+            static_cast<double>(alloc_counter::thread_count() - allocations_before), benchmark::Counter::kAvgIterations);
+    }
+}
+BENCHMARK(BM_CalculateBpmArena)->RangeMultiplier(2)->Range(64, 1024)->Unit(benchmark::kMicrosecond);
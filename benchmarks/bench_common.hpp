@@ -0,0 +1,108 @@
+#pragma once
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <dlib/image_processing/full_object_detection.h>
+#include "FaceProcessor.hpp"
+
+/**
+ * @file bench_common.hpp
+ * @brief Shared inputs for the benchmark suite: test images, synthetic frames and traces.
+ *
+ * Images are read from $HBM_BENCH_IMAGES, else from benchmarks/data (not shipped, drop
+ * your own face photos there). Without any, synthetic frames are used; detection then
+ * measures a full no-face scan, which is the worst case anyway.
+ */
+namespace bench {
+
+inline const std::vector<cv::Size>& resolutions() {
+    static const std::vector<cv::Size> sizes = {{640, 480}, {1280, 720}, {1920, 1080}};
+    return sizes;
+}
+
+inline const std::shared_ptr<const FaceModel>& model() {
+    static const auto instance = std::make_shared<const FaceModel>(MODEL_PATH); // Takes about a second; do it once
+    return instance;
+}
+
+inline FaceProcessor& processor() {
+    static FaceProcessor instance(model());
+    return instance;
+}
+
+inline cv::Mat synthetic_frame(cv::Size size, int seed = 1) {
+    cv::Mat frame(size, CV_8UC3);
+    cv::theRNG().state = static_cast<uint64_t>(seed);
+    cv::randn(frame, cv::Scalar(90, 100, 110), cv::Scalar(20, 20, 20));
+    const cv::Point c(size.width / 2, size.height / 2);
+    const int r = size.height / 4;
+    cv::ellipse(frame, c, cv::Size(r * 3 / 4, r), 0, 0, 360, cv::Scalar(120, 150, 200), cv::FILLED);
+    cv::circle(frame, c + cv::Point(-r / 3, -r / 5), r / 10, cv::Scalar(40, 40, 40), cv::FILLED);
+    cv::circle(frame, c + cv::Point(r / 3, -r / 5), r / 10, cv::Scalar(40, 40, 40), cv::FILLED);
+    cv::ellipse(frame, c + cv::Point(0, r / 2), cv::Size(r / 3, r / 10), 0, 0, 360, cv::Scalar(60, 60, 140), cv::FILLED);
+    return frame;
+}
+
+/**
+ * @brief Test images scaled to `size`, or a single synthetic frame if none are available.
+ */
+inline std::vector<cv::Mat> frames(cv::Size size) {
+    std::vector<cv::Mat> out;
+    std::filesystem::path dir = BENCH_DATA_DIR;
+    if (const char* env = std::getenv("HBM_BENCH_IMAGES")) {
+        dir = env;
+    }
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        cv::Mat img = cv::imread(entry.path().string(), cv::IMREAD_COLOR);
+        if (!img.empty()) {
+            cv::resize(img, img, size, 0, 0, cv::INTER_AREA);
+            out.push_back(std::move(img));
+        }
+    }
+    if (out.empty()) {
+        out.push_back(synthetic_frame(size));
+    }
+    return out;
+}
+
+/**
+ * @brief Landmarks for `frame`: real ones if a face is found, else a plausible frontal layout.
+ */
+inline dlib::full_object_detection landmarks(const cv::Mat& frame) {
+    if (auto face = processor().get_central_face(frame)) {
+        return *face;
+    }
+    const long cx = frame.cols / 2;
+    const long cy = frame.rows / 2;
+    const long w = frame.rows / 3;
+    std::vector<dlib::point> parts(68, dlib::point(cx, cy));
+    parts[19] = dlib::point(cx - w / 5, cy - w / 4); // Left eyebrow peak
+    parts[24] = dlib::point(cx + w / 5, cy - w / 4); // Right eyebrow peak
+    parts[27] = dlib::point(cx, cy - w / 10);        // Nose bridge
+    return dlib::full_object_detection(dlib::rectangle(cx - w / 2, cy - w / 2, cx + w / 2, cy + w / 2), parts);
+}
+
+/**
+ * @brief Mean-BGR trace with a pulse at `bpm` on top of slow drift and noise.
+ */
+inline std::vector<cv::Scalar> synthetic_trace(size_t n, double fps, double bpm = 72.0) {
+    std::vector<cv::Scalar> trace(n);
+    cv::RNG rng(7);
+    for (size_t i = 0; i < n; ++i) {
+        const double t = static_cast<double>(i) / fps;
+        const double pulse = std::sin(2.0 * CV_PI * bpm / 60.0 * t);
+        const double drift = 3.0 * std::sin(2.0 * CV_PI * 0.05 * t);
+        trace[i] = cv::Scalar(100 + drift + 0.2 * pulse + rng.gaussian(0.1),
+                              120 + drift + 0.6 * pulse + rng.gaussian(0.1),
+                              150 + drift + 0.3 * pulse + rng.gaussian(0.1));
+    }
+    return trace;
+}
+
+} // namespace bench
@@ -0,0 +1,122 @@
+#include <benchmark/benchmark.h>
+#include <dlib/image_processing.h>
+#include <dlib/image_processing/frontal_face_detector.h>
+#include <dlib/opencv.h>
+#include <algorithm>
+#include <thread>
+#include "ProcessStats.hpp"
+#include "WorkStealingPool.hpp"
+#include "bench_common.hpp"
+
+// Arg: index into bench::resolutions()
+static void apply_resolution(benchmark::State& state, cv::Size& size) {
+    size = bench::resolutions()[static_cast<size_t>(state.range(0))];
+    state.SetLabel(std::to_string(size.width) + "x" + std::to_string(size.height));
+}
+
+static void BM_Detect(benchmark::State& state) {
+    cv::Size size;
+    apply_resolution(state, size);
+    const auto frames = bench::frames(size);
+    auto detector = dlib::get_frontal_face_detector();
+    size_t i = 0;
+    for (auto _ : state) {
+        dlib::cv_image<dlib::bgr_pixel> img(frames[i++ % frames.size()]);
+        benchmark::DoNotOptimize(detector(img));
+    }
+}
+BENCHMARK(BM_Detect)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+static void BM_Predict(benchmark::State& state) {
+    cv::Size size;
+    apply_resolution(state, size);
+    const cv::Mat frame = bench::frames(size).front();
+    const auto face = bench::landmarks(frame).get_rect();
+    dlib::shape_predictor predictor;
+    dlib::deserialize(MODEL_PATH) >> predictor;
+    dlib::cv_image<dlib::bgr_pixel> img(frame);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(predictor(img, face));
+    }
+}
+BENCHMARK(BM_Predict)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+static void BM_GetCentralFace(benchmark::State& state) {
+    cv::Size size;
+    apply_resolution(state, size);
+    const auto frames = bench::frames(size);
+    auto& processor = bench::processor();
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(processor.get_central_face(frames[i++ % frames.size()]));
+    }
+}
+BENCHMARK(BM_GetCentralFace)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+static void BM_StabilizedForehead(benchmark::State& state) {
+    cv::Size size;
+    apply_resolution(state, size);
+    const cv::Mat frame = bench::frames(size).front();
+    const auto landmarks = bench::landmarks(frame);
+    const auto& processor = bench::processor();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(processor.get_stabilized_forehead(frame, landmarks));
+    }
+}
+BENCHMARK(BM_StabilizedForehead)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+static void BM_AvgBgr(benchmark::State& state) {
+    const cv::Mat frame = bench::frames(bench::resolutions()[1]).front();
+    const cv::Mat forehead = bench::processor().get_stabilized_forehead(frame, bench::landmarks(frame));
+    const auto& processor = bench::processor();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(processor.get_avg_bgr(forehead));
+    }
+    state.SetLabel(std::to_string(forehead.cols) + "x" + std::to_string(forehead.rows));
+}
+BENCHMARK(BM_AvgBgr)->Unit(benchmark::kNanosecond);
+
+namespace {
+unsigned scaling_threads() {
+    return std::max(1u, std::min(std::thread::hardware_concurrency(), 16u));
+}
+} // namespace
+
+// Throughput of N threads sharing one model (each with its own FaceProcessor context) at 720p.
+// items_per_second should grow with threads while rss_MiB stays near the single-thread figure.
+static void BM_SharedModelScaling(benchmark::State& state) {
+    const auto frames = bench::frames(bench::resolutions()[1]);
+    FaceProcessor processor(bench::model());
+    size_t i = static_cast<size_t>(state.thread_index());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(processor.get_central_face(frames[i++ % frames.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        state.counters["rss_MiB"] = static_cast<double>(process_stats::current_rss_bytes()) / (1024.0 * 1024.0);
+    }
+}
+BENCHMARK(BM_SharedModelScaling)
+    ->ThreadRange(1, static_cast<int>(scaling_threads()))
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Detection latency with one scheduler task per HOG filter. Args: resolution index, workers.
+// Agreement with the serial scan is checked by the unit tests (test_face.cpp).
+static void BM_ParallelDetect(benchmark::State& state) {
+    cv::Size size;
+    apply_resolution(state, size);
+    const auto frames = bench::frames(size);
+    WorkStealingPool pool(static_cast<unsigned>(state.range(1)));
+    FaceProcessor parallel(bench::model());
+    parallel.set_scheduler(&pool);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parallel.detect_central_face(frames[i++ % frames.size()]));
+    }
+    state.counters["workers"] = static_cast<double>(pool.size());
+}
+BENCHMARK(BM_ParallelDetect)
+    ->ArgsProduct({{0, 1, 2}, {1, 2, 5}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
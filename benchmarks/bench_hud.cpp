@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+#include "DebugVisualizer.hpp"
+#include "HudCompositor.hpp"
+#include "bench_common.hpp"
+
+namespace {
+const cv::Size kHudSize(400, 150); // config.yaml defaults
+} // namespace
+
+// Arg: number of samples plotted
+static void BM_PlotSignal(benchmark::State& state) {
+    std::vector<float> data(static_cast<size_t>(state.range(0)));
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = std::sin(0.1f * static_cast<float>(i));
+    }
+    cv::Mat canvas(75, kHudSize.width, CV_8UC4, cv::Scalar::all(0));
+    for (auto _ : state) {
+        debug_viz::plot_signal(data, canvas, cv::Scalar(0, 255, 0, 255));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_PlotSignal)->RangeMultiplier(4)->Range(64, 1024)->Unit(benchmark::kMicrosecond);
+
+// Arg: index into bench::resolutions(); the camera frame is fitted into the HUD
+static void BM_FitFrameBgra(benchmark::State& state) {
+    const cv::Size size = bench::resolutions()[static_cast<size_t>(state.range(0))];
+    state.SetLabel(std::to_string(size.width) + "x" + std::to_string(size.height));
+    const cv::Mat frame = bench::synthetic_frame(size);
+    cv::Mat scratch;
+    cv::Mat target(kHudSize, CV_8UC4);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hud::fit_frame_bgra(frame, kHudSize, scratch, target));
+    }
+}
+BENCHMARK(BM_FitFrameBgra)->DenseRange(0, 2)->Unit(benchmark::kMicrosecond);
+
+static void BM_BlendPremultiplied(benchmark::State& state) {
+    cv::Mat layer;
+    hud::to_premultiplied(bench::synthetic_frame(kHudSize), 128, layer);
+    cv::Mat target(kHudSize, CV_8UC4, cv::Scalar(10, 20, 30, 255));
+    for (auto _ : state) {
+        hud::blend_premultiplied(layer, target);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(layer.total() * 4));
+}
+BENCHMARK(BM_BlendPremultiplied)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include "HeartbeatAnalyzer.hpp"
+#include "HudCompositor.hpp"
+#include "MatPool.hpp"
+#include "ProcessStats.hpp"
+#include "bench_common.hpp"
+
+namespace {
+const cv::Size kHudSize(400, 150); // config.yaml defaults
+constexpr double kFps = 30.0;
+constexpr int kWindow = 256;
+} // namespace
+
+// Per-frame Mat traffic minus detection: capture copy, forehead warp, HUD fit, analysis.
+// Args: pooled allocator off/on, resolution index. Run long (fixed iterations) so RSS drift
+// shows: rss_growth_MiB compares the end of the run with its first quarter and should stay ~0.
+static void BM_FrameMatChurn(benchmark::State& state) {
+    const bool pooled = state.range(0) != 0;
+    const cv::Size size = bench::resolutions()[static_cast<size_t>(state.range(1))];
+    state.SetLabel(std::to_string(size.width) + "x" + std::to_string(size.height));
+
+    cv::MatAllocator* previous = cv::Mat::getDefaultAllocator();
+    PooledMatAllocator& pool = mat_pool::install(size_t{256} << 20);
+    cv::Mat::setDefaultAllocator(pooled ? &pool : cv::Mat::getStdAllocator());
+    const auto before = pool.stats();
+
+    const cv::Mat source = bench::synthetic_frame(size);
+    const auto lm = bench::landmarks(source);
+    const auto trace = bench::synthetic_trace(1024, kFps);
+    HeartbeatAnalyzer analyzer(kWindow, kFps);
+    const auto quarter = static_cast<benchmark::IterationCount>(state.max_iterations / 4);
+    benchmark::IterationCount i = 0;
+    size_t rss_quarter = 0;
+    for (auto _ : state) {
+        cv::Mat frame = source.clone();
+        const cv::Scalar avg = bench::processor().get_avg_bgr(bench::processor().get_stabilized_forehead(frame, lm));
+        cv::Mat scratch;
+        cv::Mat target(kHudSize, CV_8UC4);
+        benchmark::DoNotOptimize(hud::fit_frame_bgra(frame, kHudSize, scratch, target));
+        analyzer.add_sample(trace[static_cast<size_t>(i) & 1023] + avg * 1e-6);
+        benchmark::DoNotOptimize(analyzer.calculate_bpm(45.0, 180.0, false));
+        if (++i == quarter) {
+            rss_quarter = process_stats::current_rss_bytes();
+        }
+    }
+    const size_t rss_end = process_stats::current_rss_bytes();
+    cv::Mat::setDefaultAllocator(previous);
+
+    const auto after = pool.stats();
+    const double hits = static_cast<double>(after.hits - before.hits);
+    const double misses = static_cast<double>(after.misses - before.misses);
+    state.counters["rss_growth_MiB"] = (static_cast<double>(rss_end) - static_cast<double>(rss_quarter)) / 1048576.0;
+    state.counters["rss_MiB"] = static_cast<double>(rss_end) / 1048576.0;
+    if (pooled) {
+        state.counters["pool_hit_ratio"] = hits + misses > 0.0 ? hits / (hits + misses) : 0.0;
+        state.counters["pool_misses"] = misses;
+    }
+}
+BENCHMARK(BM_FrameMatChurn)
+    ->ArgsProduct({{0, 1}, {0, 1, 2}})
+    ->ArgNames({"pooled", "res"})
+    ->Iterations(20000)
+    ->Unit(benchmark::kMicrosecond);
+
+// Raw create/release of a 720p BGR Mat, the common case the pool exists for
+static void BM_MatCreate(benchmark::State& state) {
+    const bool pooled = state.range(0) != 0;
+    cv::MatAllocator* previous = cv::Mat::getDefaultAllocator();
+    PooledMatAllocator& pool = mat_pool::install(size_t{256} << 20);
+    cv::Mat::setDefaultAllocator(pooled ? &pool : cv::Mat::getStdAllocator());
+    for (auto _ : state) {
+        cv::Mat m(720, 1280, CV_8UC3);
+        benchmark::DoNotOptimize(m.data);
+    }
+    cv::Mat::setDefaultAllocator(previous);
+}
+BENCHMARK(BM_MatCreate)->Arg(0)->Arg(1)->ArgName("pooled");
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include "RoiStats.hpp"
+
+namespace {
+constexpr roi_stats::Isa kIsas[] = {roi_stats::Isa::Scalar, roi_stats::Isa::Sse42, roi_stats::Isa::Avx2,
+                                    roi_stats::Isa::Avx512, roi_stats::Isa::Neon};
+
+// Forehead warp, a face-sized crop and a full 1080p frame
+const cv::Size kRoiSizes[] = {{60, 45}, {320, 240}, {1920, 1080}};
+
+cv::Mat random_bgr(cv::Size size, uint64_t seed) {
+    cv::Mat bgr(size, CV_8UC3);
+    cv::theRNG().state = seed;
+    cv::randu(bgr, cv::Scalar::all(0), cv::Scalar::all(256)); // Full range so clipping is exercised
+    return bgr;
+}
+
+// Skin-like polygon mask covering roughly half the ROI
+cv::Mat polygon_mask(cv::Size size) {
+    cv::Mat mask = cv::Mat::zeros(size, CV_8UC1);
+    const cv::Point pts[] = {{size.width / 5, 0},
+                             {size.width * 4 / 5, size.height / 8},
+                             {size.width - 1, size.height * 3 / 4},
+                             {size.width / 2, size.height - 1},
+                             {0, size.height / 2}};
+    cv::fillConvexPoly(mask, pts, 5, cv::Scalar(255));
+    return mask;
+}
+
+roi_stats::Accum run(roi_stats::RowKernel k, const uint8_t* bgr, const uint8_t* mask, size_t n) {
+    roi_stats::Accum acc;
+    k(bgr, mask, n, 5, 250, acc);
+    return acc;
+}
+} // namespace
+
+// Args: index into kIsas, index into kRoiSizes, masked
+static void BM_RoiStats(benchmark::State& state) {
+    const roi_stats::Isa isa = kIsas[state.range(0)];
+    const roi_stats::RowKernel k = roi_stats::kernel(isa);
+    if (!k) {
+        state.SkipWithError((std::string(roi_stats::isa_name(isa)) + " not available on this CPU/build").c_str());
+        return;
+    }
+    const cv::Size size = kRoiSizes[state.range(1)];
+    const cv::Mat bgr = random_bgr(size, 3);
+    const cv::Mat mask = state.range(2) ? polygon_mask(size) : cv::Mat();
+    const uint8_t* mask_data = mask.empty() ? nullptr : mask.ptr<uint8_t>();
+    state.SetLabel(std::string(roi_stats::isa_name(isa)) + " " + std::to_string(size.width) + "x" +
+                   std::to_string(size.height));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(run(k, bgr.ptr<uint8_t>(), mask_data, bgr.total()));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(bgr.total() * 3));
+}
+BENCHMARK(BM_RoiStats)
+    ->ArgsProduct({{0, 1, 2, 3, 4}, {0, 1, 2}, {0, 1}})
+    ->ArgNames({"isa", "size", "masked"});
+
+// Baseline: cv::meanStdDev over the same pixels (get_avg_bgr used plain cv::mean before)
+static void BM_RoiOpenCv(benchmark::State& state) {
+    const cv::Size size = kRoiSizes[state.range(0)];
+    const cv::Mat bgr = random_bgr(size, 3);
+    const cv::Mat mask = state.range(1) ? polygon_mask(size) : cv::Mat();
+    state.SetLabel(std::to_string(size.width) + "x" + std::to_string(size.height));
+    for (auto _ : state) {
+        cv::Scalar mean;
+        cv::Scalar stddev;
+        cv::meanStdDev(bgr, mean, stddev, mask);
+        benchmark::DoNotOptimize(mean);
+        benchmark::DoNotOptimize(stddev);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(bgr.total() * 3));
+}
+BENCHMARK(BM_RoiOpenCv)->ArgsProduct({{0, 1, 2}, {0, 1}})->ArgNames({"size", "masked"});
@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Compare two Google Benchmark JSON results and flag regressions.
+
+Produce the inputs with:
+    benchmarks --benchmark_out=before.json --benchmark_out_format=json --benchmark_repetitions=5
+Then:
+    python benchmarks/compare.py before.json after.json [--threshold 0.05]
+
+Medians are compared when repetitions were run, otherwise single iterations.
+Exits with status 1 if any benchmark got slower by more than the threshold.
+"""
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    runs, medians = {}, {}
+    for b in data.get("benchmarks", []):
+        if b.get("run_type") == "aggregate":
+            if b.get("aggregate_name") == "median":
+                medians[b["run_name"]] = b
+        elif "error_occurred" not in b:
+            runs.setdefault(b.get("run_name", b["name"]), b)
+    runs.update(medians)
+    return runs
+
+
+def to_ns(bench, metric):
+    scale = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}[bench.get("time_unit", "ns")]
+    return bench[metric] * scale
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=0.05, help="relative slowdown that counts as a regression")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="real_time")
+    args = parser.parse_args()
+
+    base, cur = load(args.baseline), load(args.contender)
+    regressions = 0
+    width = max((len(n) for n in base), default=10)
+    print(f"{'benchmark':<{width}}  {'baseline':>12}  {'contender':>12}  {'change':>8}")
+    for name in sorted(base.keys() & cur.keys()):
+        before, after = to_ns(base[name], args.metric), to_ns(cur[name], args.metric)
+        change = (after - before) / before if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        elif change < -args.threshold:
+            flag = "  improved"
+        print(f"{name:<{width}}  {before:>10.0f}ns  {after:>10.0f}ns  {change:>+7.1%}{flag}")
+    for name in sorted(base.keys() - cur.keys()):
+        print(f"{name:<{width}}  missing from contender")
+    for name in sorted(cur.keys() - base.keys()):
+        print(f"{name:<{width}}  new")
+
+    print(f"\n{regressions} regression(s) above {args.threshold:.0%}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @file AllocationCounter.hpp
+ * @brief Debug hook counting global operator new calls, to check that steady-state frames don't allocate.
+ *
+ * Built with HBM_COUNT_ALLOCATIONS=1 (CMake option of the same name), the global
+ * operator new/delete family is replaced by counting wrappers around malloc/free.
+ * Otherwise nothing is replaced and every count reads 0.
+ */
+
+#ifndef HBM_COUNT_ALLOCATIONS
+#define HBM_COUNT_ALLOCATIONS 0
+#endif
+
+namespace alloc_counter {
+
+inline constexpr bool kEnabled = HBM_COUNT_ALLOCATIONS != 0;
+
+/**
+ * @brief operator new calls made by the calling thread since it started.
+ */
+uint64_t thread_count();
+
+/**
+ * @brief operator new calls across all threads since process start.
+ */
+uint64_t total_count();
+
+} // namespace alloc_counter
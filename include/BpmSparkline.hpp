@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+#include <opencv2/core.hpp>
+
+/**
+ * @class BpmSparkline
+ * @brief Scrolling BPM trend graph, one column per estimate, drawn incrementally.
+ *
+ * The vertical scale is fixed to the configured BPM range, so a new value only
+ * shifts the existing pixels one column left and draws the rightmost column.
+ * The image is premultiplied BGRA, ready for HudCompositor layers.
+ */
+class BpmSparkline {
+public:
+    /**
+     * @param size Graph size in pixels; its width is also the history length.
+     * @param bgr Line colour.
+     */
+    BpmSparkline(cv::Size size, const cv::Scalar& bgr, double min_bpm, double max_bpm);
+
+    /**
+     * @brief Appends an estimate: O(height * width) memmove plus one column of drawing.
+     */
+    void push(double bpm);
+
+    const cv::Mat& image() const { return m_pixels; }
+
+private:
+    int to_row(double bpm) const;
+    void draw_column(int x, double prev, double cur);
+
+    cv::Mat m_pixels;         // CV_8UC4, premultiplied
+    cv::Vec4b m_line;
+    cv::Vec4b m_backdrop;
+    double m_min_bpm;
+    double m_max_bpm;
+    double m_last{0.0};
+    bool m_has_last{false};
+};
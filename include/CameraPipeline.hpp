@@ -0,0 +1,147 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <opencv2/videoio.hpp>
+#include "Config.hpp"
+#include "FaceModel.hpp"
+#include "FaceProcessor.hpp"
+#include "FrameArena.hpp"
+#include "HeartbeatAnalyzer.hpp"
+#include "Instrumentation.hpp"
+#include "LatencyHistogram.hpp"
+#include "WorkStealingPool.hpp"
+
+/**
+ * @class CameraPipeline
+ * @brief One source's capture -> face -> ROI -> analysis loop, paced at its acquisition rate.
+ *
+ * Pipelines share the face model, the scheduler and the process-wide logging and metrics.
+ * Everything per-frame (capture, detector context, analyzer, arena) belongs to the pipeline
+ * and is only touched by the thread inside run(). A video file source is read in real time,
+ * like a camera: frames that went by while the pipeline was busy are skipped, not queued.
+ */
+class CameraPipeline {
+public:
+    /**
+     * @brief What one frame produced. References are valid only during the on_result() call.
+     */
+    struct FrameResult {
+        const cv::Mat& frame; // Capture after the source's frame_roi
+        const std::expected<dlib::full_object_detection, std::string>& face;
+        const cv::Mat& forehead_corners; // Filled in debug mode only
+        const HeartbeatAnalyzer& analyzer;
+        cv::Scalar avg_bgr;
+        std::optional<double> bpm;
+        std::chrono::steady_clock::time_point start;
+        std::array<uint32_t, 4> stage_us; // capture, face, roi, analyze
+        bool debug;
+    };
+
+    struct Stats {
+        uint64_t frames{0};
+        uint64_t faces{0};
+        uint64_t overruns{0}; // Frames that took over two acquisition intervals
+        double last_bpm{0.0}; // 0 until the first estimate
+    };
+
+    /**
+     * @brief Opens the source and sets up the per-camera analysis state.
+     * @param index Position in config.cameras; camera 0 also feeds the unlabelled bpm/confidence gauges.
+     * @throws std::runtime_error if the source cannot be opened.
+     */
+    CameraPipeline(size_t index, const AppConfig::CameraSource& source, const AppConfig& config,
+                   std::shared_ptr<const FaceModel> model, WorkStealingPool& scheduler);
+
+    CameraPipeline(const CameraPipeline&) = delete;
+    CameraPipeline& operator=(const CameraPipeline&) = delete;
+
+    /**
+     * @brief Sets the action run on a scheduler worker right after each capture, overlapping
+     *        detection; it has finished before on_result() runs for the same frame, so the two
+     *        may share a single-writer channel.
+     * @note Set before run() starts.
+     */
+    void on_capture(std::function<void(const cv::Mat&)> action) { m_on_capture = std::move(action); }
+
+    /**
+     * @brief Sets the action run on the pipeline thread once a frame is analysed.
+     * @note Set before run() starts.
+     */
+    void on_result(std::function<void(const FrameResult&)> action) { m_on_result = std::move(action); }
+
+    /**
+     * @brief Processes frames until stop is requested or the source ends.
+     */
+    void run(std::stop_token st);
+
+    /**
+     * @brief Enables debug capture (landmark corners, analyzer signals, timing logs). Any thread.
+     */
+    void set_debug(bool enabled) { m_debug.store(enabled, std::memory_order_relaxed); }
+
+    bool finished() const { return m_finished.load(std::memory_order_acquire); }
+    size_t index() const { return m_index; }
+    const std::string& name() const { return m_source.name; }
+    Stats stats() const;
+
+private:
+    bool read_frame();
+    void process(std::chrono::steady_clock::time_point frame_start);
+    void log_timing(std::chrono::steady_clock::time_point now);
+
+    size_t m_index;
+    AppConfig::CameraSource m_source;
+    double m_min_bpm;
+    double m_max_bpm;
+    WorkStealingPool& m_scheduler;
+
+    cv::VideoCapture m_cap;
+    bool m_is_file{false};
+    double m_video_fps{30.0};
+    std::chrono::steady_clock::time_point m_clock_start; // File sources: when playback started
+    double m_pass_offset{0.0}; // File time at which the current loop over the video started
+    size_t m_pass_frames{0};
+
+    FaceProcessor m_processor;
+    HeartbeatAnalyzer m_analyzer;
+    FrameArena m_arena;
+    std::chrono::steady_clock::duration m_interval;
+    cv::Mat m_frame;
+    cv::Mat m_forehead_corners;
+
+    std::function<void(const cv::Mat&)> m_on_capture;
+    std::function<void(const FrameResult&)> m_on_result;
+
+    std::atomic<bool> m_debug{false};
+    std::atomic<bool> m_finished{false};
+    std::atomic<uint64_t> m_frames{0};
+    std::atomic<uint64_t> m_faces{0};
+    std::atomic<uint64_t> m_overruns{0};
+    std::atomic<double> m_last_bpm{0.0};
+
+    // Debug timing log, pipeline thread only
+    LatencyHistogram m_sample_dt_ns;
+    HistogramSnapshot m_sample_dt_window_start;
+    std::optional<std::chrono::steady_clock::time_point> m_last_sample_time;
+    std::chrono::steady_clock::time_point m_last_stats_log;
+    std::chrono::steady_clock::time_point m_last_buffer_log;
+    bool m_buffer_ready_logged{false};
+    uint64_t m_window_frames{0};
+    uint64_t m_window_faces{0};
+    uint64_t m_window_allocations{0};
+
+#if HBM_INSTRUMENTATION
+    // Per-camera metrics, named after the camera
+    instr::GaugeId m_bpm_gauge{0};
+    instr::GaugeId m_confidence_gauge{0};
+    instr::GaugeId m_face_ratio_gauge{0};
+#endif
+};
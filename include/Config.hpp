@@ -9,11 +9,24 @@
  * @brief Thread-safe configuration container loaded from YAML.
  */
 struct AppConfig {
+    static constexpr size_t kMaxCameras = 8; // HUD has room for this many BPM lines
+
     struct {
         double fps;
         double acquisition_fps;
         cv::Rect frame_roi;
-    } camera;
+    } camera; // Defaults for every entry in cameras
+
+    struct CameraSource {
+        std::string name;   // Unique; labels the camera's metrics and HUD line
+        std::string source; // Device index ("0") or a video file / stream URL
+        int width, height;  // Requested capture size, 0 keeps the driver default
+        double fps;
+        double acquisition_fps;
+        cv::Rect frame_roi;
+        bool loop; // Files only: restart at the end instead of stopping
+    };
+    std::vector<CameraSource> cameras; // cameras[0] is the primary: HUD preview, debug, recording
 
     struct {
         double window_duration_seconds;
@@ -28,8 +41,57 @@ struct AppConfig {
         int font_size;
         int r, g, b;
         std::string hotkey_toggle_debug;
+        std::string hotkey_dump_log; // Empty disables it
+        std::string hotkey_dump_trace; // Empty disables it
+        double debug_fps; // Cap for the background debug renderer
+        int sparkline_height; // BPM trend strip at the bottom, 0 disables it
     } hud;
 
+    struct {
+        bool enabled;
+        std::string name;
+        int preview_width, preview_height; // 0 disables the preview
+    } shared_memory;
+
+    struct {
+        size_t queue_size;
+        size_t ring_size;
+        std::string dump_path;
+    } logging;
+
+    struct {
+        bool enabled;
+        size_t capacity; // Most recent zone events kept for export
+        std::string dump_path;
+        bool dump_on_exit;
+    } tracing;
+
+    struct {
+        bool enabled;
+        std::string bind_address;
+        int port;
+        std::string unix_socket; // POSIX only; overrides bind_address/port when set
+    } metrics;
+
+    struct {
+        bool enabled;
+        std::string path;
+        size_t chunk_frames; // Rows per compressed chunk; at most one chunk is lost on a crash
+    } recording;
+
+    struct {
+        unsigned threads; // 0 = one per hardware thread
+        bool pin_workers;
+        unsigned first_core;
+        int spin_us; // Busy-wait before an idle worker parks
+        bool parallel_detection; // One task per detector filter instead of a serial scan
+    } scheduler;
+
+    struct {
+        bool pooled_mats; // Recycle cv::Mat buffers by size class (process-wide)
+        size_t mat_pool_max_bytes;
+    } memory;
+
     /**
      * @brief Parses config.yaml into the struct.
      * @return std::expected containing config or error string.
@@ -0,0 +1,85 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <dlib/image_processing/full_object_detection.h>
+#include "HeartbeatAnalyzer.hpp"
+#include "TripleBuffer.hpp"
+
+/**
+ * @struct DebugSnapshot
+ * @brief Copy of the small pieces of pipeline state the debug view draws from.
+ */
+struct DebugSnapshot {
+    bool enabled{false};
+    cv::Size frame_size;
+    std::vector<float> signal;
+    std::vector<float> spectrum;
+    std::vector<cv::Point> landmarks;
+    cv::Rect face_rect;
+    std::array<cv::Point, 4> forehead{};
+    bool has_forehead{false};
+};
+
+/**
+ * @class DebugVisualizer
+ * @brief Renders debug plots and landmarks on a low-priority thread at a capped rate.
+ *
+ * The processing thread only copies a DebugSnapshot into a triple buffer; the
+ * worker turns the latest snapshot into a premultiplied BGRA layer and hands it
+ * to the sink (the HUD).
+ */
+class DebugVisualizer {
+public:
+    using LayerSink = std::function<void(const cv::Mat& bgra_premultiplied)>;
+
+    /**
+     * @param hud_size Maximum HUD size; the layer matches the aspect-fit frame preview.
+     * @param max_fps Upper bound on renders per second.
+     * @param sink Receives each rendered layer, or an empty Mat when debug is switched off.
+     */
+    DebugVisualizer(cv::Size hud_size, double max_fps, LayerSink sink);
+
+    /**
+     * @brief Publishes the current analyzer/face state. Called from the processing thread.
+     * @param landmarks Optional landmarks of the tracked face.
+     * @param forehead_corners Optional 4x1 CV_32SC2 ROI corners from get_stabilized_forehead.
+     */
+    void submit(cv::Size frame_size, const HeartbeatAnalyzer& analyzer,
+                const dlib::full_object_detection* landmarks, const cv::Mat* forehead_corners);
+
+    /**
+     * @brief Hides the debug layer. Cheap to call every frame.
+     */
+    void disable();
+
+private:
+    void run(std::stop_token st);
+    void render(const DebugSnapshot& snap);
+
+    cv::Size m_hud_size;
+    std::chrono::steady_clock::duration m_interval;
+    LayerSink m_sink;
+
+    TripleBuffer<DebugSnapshot> m_snapshots;
+    bool m_enabled{false};  // Producer-side, avoids republishing "disabled"
+    bool m_visible{false};  // Worker-side
+    cv::Mat m_layer;
+
+    std::mutex m_sleep_mtx;
+    std::condition_variable_any m_sleep_cv;
+    std::jthread m_worker; // Last member: joined before the rest is destroyed
+};
+
+namespace debug_viz {
+/**
+ * @brief Draws a min/max-normalized polyline of data across the whole canvas.
+ */
+void plot_signal(std::span<const float> data, cv::Mat& canvas, const cv::Scalar& color);
+} // namespace debug_viz
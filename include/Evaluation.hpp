@@ -0,0 +1,92 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+/**
+ * @file Evaluation.hpp
+ * @brief Ground-truth loading and accuracy metrics for offline evaluation tools.
+ */
+namespace eval {
+
+/**
+ * @struct GroundTruth
+ * @brief Reference heart rate over time, sorted by time.
+ */
+struct GroundTruth {
+    std::vector<double> time_s;
+    std::vector<double> hr_bpm;
+
+    /**
+     * @brief Linearly interpolated HR at t, clamped to the recorded range.
+     */
+    double hr_at(double t) const;
+
+    /**
+     * @brief Mean reference HR over [t0, t1], matching what a window ending at t1 should estimate.
+     */
+    double mean_hr(double t0, double t1) const;
+    bool empty() const { return time_s.empty(); }
+};
+
+/**
+ * @brief Reads UBFC-rPPG ground truth from a subject directory.
+ *
+ * Supports DATASET_2's ground_truth.txt (lines: PPG, HR, timestamps in s) and
+ * DATASET_1's gtdump.xmp (CSV rows: time ms, HR, SpO2, PPG).
+ */
+std::expected<GroundTruth, std::string> load_ground_truth(const std::filesystem::path& subject_dir);
+
+/**
+ * @struct DatasetEntry
+ * @brief One subject: a video plus the directory holding its ground truth.
+ */
+struct DatasetEntry {
+    std::string name;
+    std::filesystem::path video;
+    std::filesystem::path dir;
+};
+
+/**
+ * @brief Finds subject directories (vid.avi or any .avi/.mp4/.mkv next to ground truth), sorted by name.
+ */
+std::vector<DatasetEntry> discover_ubfc(const std::filesystem::path& root);
+
+/**
+ * @struct ErrorStats
+ * @brief Agreement between paired estimates and references (BPM).
+ */
+struct ErrorStats {
+    size_t n{0};
+    double mae{0.0};
+    double rmse{0.0};
+    double pearson{0.0}; // 0 when either side has no variance
+};
+
+ErrorStats error_stats(std::span<const double> estimate, std::span<const double> reference);
+
+/**
+ * @struct SampleTrace
+ * @brief Per-frame ROI averages of one video at its native rate, so analysis can be replayed without detection.
+ */
+struct SampleTrace {
+    std::vector<double> time_s;
+    std::vector<bool> face;                    // false: no face in that frame, bgr is zero
+    std::vector<std::array<double, 3>> bgr;
+
+    size_t size() const { return time_s.size(); }
+    double duration() const { return time_s.empty() ? 0.0 : time_s.back() - time_s.front(); }
+    double fps() const { return size() > 1 && duration() > 0.0 ? (size() - 1) / duration() : 0.0; }
+};
+
+/**
+ * @brief Reads a trace written by save_sample_trace (CSV: time_s,face,b,g,r).
+ */
+std::expected<SampleTrace, std::string> load_sample_trace(const std::filesystem::path& file);
+std::expected<void, std::string> save_sample_trace(const SampleTrace& trace, const std::filesystem::path& file);
+
+} // namespace eval
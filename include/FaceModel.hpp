@@ -0,0 +1,52 @@
+#ifndef FACE_MODEL_HPP
+#define FACE_MODEL_HPP
+
+#include <dlib/image_processing.h>
+#include <dlib/image_processing/frontal_face_detector.h>
+#include <string>
+#include <vector>
+
+/**
+ * @class FaceModel
+ * @brief Immutable face model: landmark regression trees and the HOG detector filters.
+ *
+ * Loaded once and shared between threads as std::shared_ptr<const FaceModel>; every
+ * FaceProcessor is a per-thread context over it. All members are read-only after
+ * construction, so concurrent use through the const interface is safe.
+ */
+class FaceModel {
+public:
+    /**
+     * @brief Loads the dlib shape predictor and builds the frontal face detector.
+     * @param model_path Path to the .dat landmark model file.
+     * @throws std::runtime_error if model cannot be loaded.
+     */
+    explicit FaceModel(const std::string& model_path);
+
+    FaceModel(const FaceModel&) = delete;
+    FaceModel& operator=(const FaceModel&) = delete;
+
+    /**
+     * @brief Landmark regressor. Its operator() is const and may be called from any thread.
+     */
+    const dlib::shape_predictor& shape_predictor() const { return m_shape_predictor; }
+
+    /**
+     * @brief Detector prototype. dlib's detector keeps its feature pyramid as mutable scanner
+     *        state, so contexts copy this (a few hundred KB of filters) rather than call it.
+     */
+    const dlib::frontal_face_detector& detector() const { return m_detector; }
+
+    /**
+     * @brief The detector split into one single-filter detector per HOG filter (frontal, left,
+     *        right, ...), so a frame can be scanned by several workers at once.
+     */
+    const std::vector<dlib::frontal_face_detector>& detector_parts() const { return m_detector_parts; }
+
+private:
+    dlib::frontal_face_detector m_detector;
+    std::vector<dlib::frontal_face_detector> m_detector_parts;
+    dlib::shape_predictor m_shape_predictor;
+};
+
+#endif
@@ -4,41 +4,62 @@
 #include <opencv2/opencv.hpp>
 #include <dlib/image_processing.h>
 #include <dlib/image_processing/frontal_face_detector.h>
+#include <dlib/opencv.h>
 #include <expected>
+#include <memory>
 #include <string>
-
-struct FaceTimings {
-    double detect_ms{0.0};
-    double select_ms{0.0};
-    double predict_ms{0.0};
-};
+#include "FaceModel.hpp"
+#include "WorkStealingPool.hpp"
 
 /**
  * @class FaceProcessor
  * @brief Logic for face detection and landmark-based ROI extraction.
+ *
+ * A per-thread context over a shared FaceModel: it owns the detector's scanner state
+ * (HOG feature pyramid) and detection buffers, so use one instance per thread.
  */
 class FaceProcessor {
 public:
     /**
-     * @brief Constructor. Loads the dlib shape predictor model.
+     * @brief Constructor. Loads a model used only by this processor.
      * @param model_path Path to the .dat landmark model file.
      * @throws std::runtime_error if model cannot be loaded.
      */
     explicit FaceProcessor(const std::string& model_path);
 
     /**
-    * @brief Draws face bounding box, landmarks, and forehead ROI onto the frame.
-    */
-    void draw_debug(cv::Mat& frame, const dlib::full_object_detection& landmarks, cv::Mat forehead_rect) const;
+     * @brief Constructor. Creates a context over an already loaded, possibly shared model.
+     */
+    explicit FaceProcessor(std::shared_ptr<const FaceModel> model);
+
+    const std::shared_ptr<const FaceModel>& model() const { return m_model; }
+
+    /**
+     * @brief Runs detection as one scheduler task per detector filter, joined before returning.
+     *        Lowers detection latency at the cost of building the HOG pyramid once per filter.
+     * @param scheduler Pool to fan out on; nullptr restores single-threaded detection.
+     */
+    void set_scheduler(WorkStealingPool* scheduler);
 
     /**
      * @brief Finds the face closest to the center of the image.
      * @param frame The input BGR image.
-     * @param timings Optional timing breakdown (detect/select/predict).
      * @return std::expected containing landmarks on success.
      */
-    std::expected<dlib::full_object_detection, std::string> get_central_face(
-        const cv::Mat& frame, FaceTimings* timings = nullptr);
+    std::expected<dlib::full_object_detection, std::string> get_central_face(const cv::Mat& frame);
+
+    /**
+     * @brief Detection half of get_central_face(): the face box closest to the image center.
+     * @param frame The input BGR image.
+     * @return std::expected containing the face rectangle on success.
+     */
+    std::expected<dlib::rectangle, std::string> detect_central_face(const cv::Mat& frame);
+
+    /**
+     * @brief Landmark half of get_central_face(). Only reads the shared model, so it may run on
+     *        any thread, independently of the processor that detected the face.
+     */
+    dlib::full_object_detection predict_landmarks(const cv::Mat& frame, const dlib::rectangle& face) const;
 
     /**
      * @brief Calculates a rectangular ROI on the forehead based on eyebrow landmarks.
@@ -56,8 +77,15 @@ public:
     cv::Scalar get_avg_bgr(const cv::Mat& frame) const;
 
 private:
-    dlib::frontal_face_detector m_detector;
-    dlib::shape_predictor m_shape_predictor;
+    void detect_parts(const dlib::cv_image<dlib::bgr_pixel>& image);
+
+    std::shared_ptr<const FaceModel> m_model;
+    dlib::frontal_face_detector m_detector; // Copy of the model's; detection mutates scanner state
+    std::vector<dlib::rect_detection> m_detections; // Reused across frames
+
+    WorkStealingPool* m_scheduler{nullptr};
+    std::vector<dlib::frontal_face_detector> m_parts; // Copies of the model's, one per task
+    std::vector<std::vector<dlib::rect_detection>> m_part_detections;
 };
 
 #endif
@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+/**
+ * @class FrameArena
+ * @brief Monotonic scratch memory for one frame's transient containers.
+ *
+ * Pass resource() down the per-frame call path and call reset() once the frame is done;
+ * nothing allocated from it may outlive that point. Allocation is a pointer bump and
+ * deallocation is free. If a frame overflows the block, the overflow comes from the heap
+ * and the next reset() grows the block, so steady-state frames never touch the heap.
+ */
+class FrameArena {
+public:
+    explicit FrameArena(size_t initial_bytes = 64 * 1024);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*m_resource; }
+
+    /**
+     * @brief Releases everything allocated since the last reset.
+     */
+    void reset();
+
+    size_t capacity() const { return m_capacity; }
+    size_t overflows() const { return m_overflows; } // Resets that had to grow the block
+
+private:
+    // Upstream for the monotonic resource; notes that the block was too small
+    class OverflowTracker : public std::pmr::memory_resource {
+    public:
+        bool overflowed{false};
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    size_t m_capacity;
+    size_t m_overflows{0};
+    std::unique_ptr<std::byte[]> m_block;
+    OverflowTracker m_upstream;
+    std::optional<std::pmr::monotonic_buffer_resource> m_resource; // Re-emplaced when the block grows
+};
@@ -2,6 +2,7 @@
 #include <deque>
 #include <vector>
 #include <expected>
+#include <memory_resource>
 #include <string>
 #include <opencv2/core.hpp>
 
@@ -24,20 +25,29 @@ public:
 
     /**
      * @brief Processes the BGR buffer using the POS algorithm and FFT.
+     * @param debug_capture Keep the windowed POS signal and FFT magnitude for debug_signal()/debug_spectrum().
+     * @param scratch Memory for the per-call channel/projection arrays (e.g. a FrameArena); freed by the caller.
      * @return std::expected containing the BPM or an error message.
      */
-    std::expected<double, std::string> calculate_bpm(double min_b, double max_b, bool debug_plot);
+    std::expected<double, std::string> calculate_bpm(double min_b, double max_b, bool debug_capture,
+        std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+    /**
+     * @brief Share of in-band spectral power at the last reported peak (±1 bin), in [0, 1].
+     */
+    double confidence() const { return m_confidence; }
 
     size_t buffer_size() const { return m_buffer.size(); }
     size_t window_size() const { return m_ws; }
-    bool has_debug_plots() const { return !m_debug_fft_input.empty() && !m_debug_fft_magnitude.empty(); }
-    const cv::Mat& debug_fft_input() const { return m_debug_fft_input; }
-    const cv::Mat& debug_fft_magnitude() const { return m_debug_fft_magnitude; }
+    bool has_debug_data() const { return !m_debug_signal.empty() && !m_debug_spectrum.empty(); }
+    const std::vector<float>& debug_signal() const { return m_debug_signal; }
+    const std::vector<float>& debug_spectrum() const { return m_debug_spectrum; }
 
 private:
     std::deque<cv::Scalar> m_buffer;
     size_t m_ws;
     double m_fps;
-    cv::Mat m_debug_fft_input;
-    cv::Mat m_debug_fft_magnitude;
+    double m_confidence{0.0};
+    std::vector<float> m_debug_signal;    // Windowed POS signal fed to the FFT
+    std::vector<float> m_debug_spectrum;  // FFT magnitude up to Nyquist
 };
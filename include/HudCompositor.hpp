@@ -0,0 +1,119 @@
+#pragma once
+#include <array>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <opencv2/core.hpp>
+
+/**
+ * @struct GlyphAtlas
+ * @brief Pre-rasterized coverage masks for the handful of characters the HUD draws.
+ */
+struct GlyphAtlas {
+    struct Glyph {
+        cv::Rect cell;   // Region in coverage; empty if the character is missing
+        int advance{0};
+    };
+
+    /// Printable ASCII (0x20-0x7E): the BPM text plus camera names, which come from the config.
+    static constexpr std::string_view kHudCharset =
+        " !\"#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~";
+
+    cv::Mat coverage;    // CV_8UC1, all cells share line_height rows
+    std::array<Glyph, 128> glyphs{};
+    int line_height{0};
+
+    /**
+     * @brief Packs per-character coverage cells (all of equal height) into one atlas.
+     * @param cells Pairs of character and CV_8UC1 cell whose width is the advance.
+     */
+    static GlyphAtlas pack(const std::vector<std::pair<char, cv::Mat>>& cells);
+
+    /**
+     * @brief Portable rasterizer using OpenCV's Hershey font.
+     * @param pixel_height Target cap-to-descender height in pixels.
+     */
+    static GlyphAtlas rasterize_hershey(std::string_view charset, int pixel_height);
+};
+
+/**
+ * @struct HudLayer
+ * @brief A premultiplied BGRA image blended over the HUD at a given origin.
+ */
+struct HudLayer {
+    const cv::Mat* bgra{nullptr};
+    cv::Point origin;
+};
+
+/**
+ * @class HudCompositor
+ * @brief Platform-independent renderer of the HUD into a BGRA buffer.
+ *
+ * The caller owns the target (on Windows it is the overlay's DIB back buffer),
+ * so composing a frame performs no allocations once the glyphs are prepared.
+ */
+class HudCompositor {
+public:
+    /**
+     * @param atlas Glyphs for the BPM text.
+     * @param text_bgr Foreground text colour; a black shadow is drawn 2px offset.
+     */
+    HudCompositor(GlyphAtlas atlas, const cv::Scalar& text_bgr);
+
+    /**
+     * @brief Renders frame preview, layers and text into target.
+     * @param target CV_8UC4 destination, fully overwritten.
+     * @param frame Opaque BGRA preview; scaled to target if sizes differ, black if empty.
+     */
+    void compose(cv::Mat& target, const cv::Mat& frame, std::span<const HudLayer> layers,
+                 std::string_view text) const;
+
+    /**
+     * @brief Draws text (with shadow) at origin using the glyph atlas. '\n' starts a new line.
+     */
+    void draw_text(cv::Mat& target, cv::Point origin, std::string_view text) const;
+
+    /**
+     * @brief Bounding box of draw_text output at (0, 0), shadow included.
+     */
+    cv::Size measure(std::string_view text) const;
+
+private:
+    void blit_glyphs(cv::Mat& target, cv::Point origin, std::string_view text, const cv::Mat& glyphs) const;
+
+    GlyphAtlas m_atlas;
+    cv::Mat m_text_fg;      // Atlas premultiplied with the text colour (CV_8UC4)
+    cv::Mat m_text_shadow;  // Atlas premultiplied with black (CV_8UC4)
+};
+
+namespace hud {
+/**
+ * @brief dst = src + dst * (255 - src.a) / 255 for premultiplied CV_8UC4 images of equal size.
+ * @note SSE2/NEON with a bit-exact scalar fallback.
+ */
+void blend_premultiplied(const cv::Mat& src, cv::Mat& dst);
+
+/**
+ * @brief The scalar path of blend_premultiplied, always; the reference the SIMD paths must match.
+ */
+void blend_premultiplied_scalar(const cv::Mat& src, cv::Mat& dst);
+
+/**
+ * @brief Blends src over dst at origin, clipping to dst.
+ */
+void blend_premultiplied_at(const cv::Mat& src, cv::Mat& dst, cv::Point origin);
+
+/**
+ * @brief Converts a BGR image into premultiplied BGRA with uniform opacity.
+ */
+void to_premultiplied(const cv::Mat& bgr, uint8_t alpha, cv::Mat& out);
+
+/**
+ * @brief Aspect-fits a BGR frame into max_size and writes it as BGRA into target's top-left corner.
+ * @param scratch Reused buffer for the downscaled frame.
+ * @param target CV_8UC4 image at least max_size large (e.g. a DIB surface).
+ * @return Size of the written region.
+ */
+cv::Size fit_frame_bgra(const cv::Mat& bgr, cv::Size max_size, cv::Mat& scratch, cv::Mat& target);
+} // namespace hud
@@ -0,0 +1,227 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "LatencyHistogram.hpp"
+#include "SpscRing.hpp"
+
+/**
+ * @file Instrumentation.hpp
+ * @brief Scoped timing zones, counters and gauges with pluggable backends.
+ *
+ * Each thread records into its own wait-free buffer; a Collector drains all
+ * buffers on a background thread and forwards events to the backends (log
+ * summaries, traces, metrics). Build with HBM_INSTRUMENTATION=0 to compile
+ * every HBM_* macro away.
+ */
+
+#ifndef HBM_INSTRUMENTATION
+#define HBM_INSTRUMENTATION 1
+#endif
+
+namespace instr {
+
+using ZoneId = uint16_t;
+using CounterId = uint16_t;
+using GaugeId = uint16_t;
+
+inline constexpr size_t kMaxZones = 64;
+inline constexpr size_t kMaxCounters = 64;
+inline constexpr size_t kMaxGauges = 64;
+inline constexpr size_t kZoneRingSize = 8192;
+
+struct ZoneEvent {
+    int64_t start_ns{0};
+    int64_t end_ns{0};
+    ZoneId zone{0};
+};
+
+/**
+ * @struct ThreadBuffer
+ * @brief Per-thread storage written only by its owner thread.
+ */
+struct ThreadBuffer {
+    uint32_t index{0};
+    uint64_t os_id{0};
+    std::string name;
+    SpscRing<ZoneEvent, kZoneRingSize> zones;
+    std::array<std::atomic<uint64_t>, kMaxCounters> counters{};
+    std::atomic<uint64_t> dropped{0};
+};
+
+/** @brief Returns the id for name, registering it on first use. Same name, same id. */
+ZoneId register_zone(std::string_view name);
+CounterId register_counter(std::string_view name);
+GaugeId register_gauge(std::string_view name);
+
+std::string_view zone_name(ZoneId id);
+std::string_view counter_name(CounterId id);
+std::string_view gauge_name(GaugeId id);
+size_t zone_count();
+size_t counter_count();
+size_t gauge_count();
+
+/**
+ * @brief Buffer of the calling thread, registered with the collector on first use.
+ */
+ThreadBuffer& this_thread_buffer();
+
+/**
+ * @brief Labels the calling thread in log and trace output.
+ */
+void set_thread_name(std::string_view name);
+
+/**
+ * @brief Copy of a thread's label, safe against a concurrent set_thread_name().
+ */
+std::string thread_name(const ThreadBuffer& thread);
+
+/**
+ * @brief Snapshot of all registered thread buffers (they outlive their threads).
+ */
+std::vector<std::shared_ptr<ThreadBuffer>> threads();
+
+inline int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline void record_zone(ZoneId id, int64_t start_ns, int64_t end_ns) {
+    ThreadBuffer& b = this_thread_buffer();
+    if (!b.zones.try_push({start_ns, end_ns, id})) {
+        b.dropped.store(b.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+inline void add_counter(CounterId id, uint64_t n) {
+    // Single writer per cell, so a plain load/store pair is enough
+    auto& cell = this_thread_buffer().counters[id];
+    cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sum of a counter over all threads.
+ */
+uint64_t counter_total(CounterId id);
+
+void set_gauge(GaugeId id, double value);
+double gauge_value(GaugeId id);
+
+/**
+ * @class ScopedZone
+ * @brief Records [construction, destruction) as one zone event.
+ */
+class ScopedZone {
+public:
+    explicit ScopedZone(ZoneId id) : m_id(id), m_start(now_ns()) {}
+    ~ScopedZone() { record_zone(m_id, m_start, now_ns()); }
+    ScopedZone(const ScopedZone&) = delete;
+    ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+    ZoneId m_id;
+    int64_t m_start;
+};
+
+/**
+ * @class Backend
+ * @brief Consumer of drained instrumentation data. Called only from the collector thread.
+ */
+class Backend {
+public:
+    virtual ~Backend() = default;
+    virtual void on_zone(const ThreadBuffer& thread, const ZoneEvent& event) = 0;
+    /** @brief Called after each drain pass. */
+    virtual void on_tick(int64_t /*now_ns*/) {}
+};
+
+/**
+ * @class Collector
+ * @brief Periodically drains every thread buffer into the registered backends.
+ */
+class Collector {
+public:
+    explicit Collector(std::chrono::milliseconds period = std::chrono::milliseconds(50));
+    ~Collector();
+
+    void add_backend(std::shared_ptr<Backend> backend);
+
+    /**
+     * @brief Drains all buffers now; also used for the final pass on shutdown.
+     */
+    void drain();
+
+private:
+    std::mutex m_mtx;
+    std::vector<std::shared_ptr<Backend>> m_backends;
+    std::chrono::milliseconds m_period;
+    std::jthread m_worker;
+};
+
+/**
+ * @class StageHistograms
+ * @brief Session-long latency histogram (ns) per zone, readable from any thread.
+ */
+class StageHistograms : public Backend {
+public:
+    void on_zone(const ThreadBuffer& thread, const ZoneEvent& event) override;
+    const LatencyHistogram& zone(ZoneId id) const { return m_zones[id]; }
+
+private:
+    std::array<LatencyHistogram, kMaxZones> m_zones;
+};
+
+/**
+ * @class LogBackend
+ * @brief Logs per-stage percentiles over the last interval at debug level.
+ * @note Add after the StageHistograms it reads so each tick sees the latest events.
+ */
+class LogBackend : public Backend {
+public:
+    explicit LogBackend(std::shared_ptr<const StageHistograms> stages,
+                        std::chrono::milliseconds interval = std::chrono::seconds(2));
+    void on_zone(const ThreadBuffer& /*thread*/, const ZoneEvent& /*event*/) override {}
+    void on_tick(int64_t now_ns) override;
+
+private:
+    std::shared_ptr<const StageHistograms> m_stages;
+    std::vector<HistogramSnapshot> m_window_start; // Per zone, at the last log line
+    int64_t m_interval_ns;
+    int64_t m_last_log_ns{0};
+    uint64_t m_reported_drops{0};
+};
+
+} // namespace instr
+
+#define HBM_CONCAT_INNER(a, b) a##b
+#define HBM_CONCAT(a, b) HBM_CONCAT_INNER(a, b)
+
+#if HBM_INSTRUMENTATION
+/// Times the rest of the enclosing scope as stage `name`.
+#define HBM_ZONE(name)                                                                         \
+    static const ::instr::ZoneId HBM_CONCAT(hbm_zone_id_, __LINE__) = ::instr::register_zone(name); \
+    const ::instr::ScopedZone HBM_CONCAT(hbm_zone_, __LINE__)(HBM_CONCAT(hbm_zone_id_, __LINE__))
+#define HBM_COUNTER_ADD(name, n)                                                               \
+    do {                                                                                       \
+        static const ::instr::CounterId hbm_counter_id = ::instr::register_counter(name);      \
+        ::instr::add_counter(hbm_counter_id, (n));                                             \
+    } while (0)
+#define HBM_GAUGE_SET(name, v)                                                                 \
+    do {                                                                                       \
+        static const ::instr::GaugeId hbm_gauge_id = ::instr::register_gauge(name);            \
+        ::instr::set_gauge(hbm_gauge_id, (v));                                                 \
+    } while (0)
+#define HBM_THREAD_NAME(name) ::instr::set_thread_name(name)
+#else
+#define HBM_ZONE(name) ((void)0)
+#define HBM_COUNTER_ADD(name, n) ((void)0)
+#define HBM_GAUGE_SET(name, v) ((void)0)
+#define HBM_THREAD_NAME(name) ((void)0)
+#endif
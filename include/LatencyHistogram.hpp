@@ -0,0 +1,181 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @file LatencyHistogram.hpp
+ * @brief Fixed-memory, log-bucketed (HDR-style) histogram for latencies.
+ *
+ * Values below 2^kSubBits are exact; above that, each power of two is split into
+ * 2^kSubBits linear sub-buckets, so any value is reported within ~3%.
+ * Values beyond 2^(kMaxMsb+1) saturate into the last bucket.
+ */
+
+namespace latency {
+
+inline constexpr unsigned kSubBits = 5;
+inline constexpr uint64_t kSubCount = uint64_t{1} << kSubBits;
+inline constexpr unsigned kMaxMsb = 40; // ~2.2e12, i.e. 36 minutes in ns
+inline constexpr size_t kBuckets = (kMaxMsb - kSubBits + 1) * kSubCount + kSubCount;
+
+constexpr size_t bucket_index(uint64_t v) {
+    if (v < kSubCount) {
+        return static_cast<size_t>(v);
+    }
+    const unsigned msb = static_cast<unsigned>(std::bit_width(v)) - 1;
+    if (msb > kMaxMsb) {
+        return kBuckets - 1;
+    }
+    const unsigned shift = msb - kSubBits;
+    return static_cast<size_t>((shift + 1) * kSubCount + ((v >> shift) - kSubCount));
+}
+
+constexpr uint64_t bucket_lower(size_t index) {
+    if (index < kSubCount) {
+        return index;
+    }
+    const uint64_t shift = index / kSubCount - 1;
+    return (index % kSubCount + kSubCount) << shift;
+}
+
+constexpr uint64_t bucket_upper(size_t index) {
+    return index + 1 < kBuckets ? bucket_lower(index + 1) - 1 : std::numeric_limits<uint64_t>::max();
+}
+
+static_assert(bucket_index(kSubCount - 1) == kSubCount - 1);
+static_assert(bucket_index(kSubCount) == kSubCount);
+static_assert(bucket_lower(bucket_index(1000)) <= 1000 && 1000 <= bucket_upper(bucket_index(1000)));
+
+} // namespace latency
+
+/**
+ * @struct HistogramSnapshot
+ * @brief Plain copy of a LatencyHistogram; cheap to diff and merge off the hot path.
+ */
+struct HistogramSnapshot {
+    std::array<uint64_t, latency::kBuckets> counts{};
+    uint64_t total{0};
+    uint64_t sum{0};
+    uint64_t min{std::numeric_limits<uint64_t>::max()};
+    uint64_t max{0};
+
+    /**
+     * @brief Adds another histogram's samples (e.g. from a different thread or stream).
+     */
+    void merge(const HistogramSnapshot& other) {
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    /**
+     * @brief Samples recorded after `earlier` was taken, for rolling windows.
+     * @note min/max of the window are bucket bounds, not exact values.
+     */
+    HistogramSnapshot since(const HistogramSnapshot& earlier) const {
+        HistogramSnapshot d;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            d.counts[i] = counts[i] - earlier.counts[i];
+            if (d.counts[i] != 0) {
+                d.min = std::min(d.min, latency::bucket_lower(i));
+                d.max = std::max<uint64_t>(d.max, std::min(latency::bucket_upper(i), max));
+            }
+        }
+        d.total = total - earlier.total;
+        d.sum = sum - earlier.sum;
+        return d;
+    }
+
+    double mean() const { return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0; }
+
+    /**
+     * @brief Value at quantile q in [0, 1] (bucket midpoint clamped to min/max), 0 if empty.
+     */
+    uint64_t percentile(double q) const {
+        if (total == 0) {
+            return 0;
+        }
+        const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total)));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= std::max<uint64_t>(rank, 1)) {
+                const uint64_t lo = latency::bucket_lower(i);
+                const uint64_t mid = lo + (std::min(latency::bucket_upper(i), max) - lo) / 2;
+                return std::clamp(mid, min, max);
+            }
+        }
+        return max;
+    }
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Concurrent histogram: record() is a few relaxed atomic ops, safe from any thread.
+ */
+class LatencyHistogram {
+public:
+    void record(uint64_t value) {
+        m_counts[latency::bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+        uint64_t cur = m_min.load(std::memory_order_relaxed);
+        while (value < cur && !m_min.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+        cur = m_max.load(std::memory_order_relaxed);
+        while (value > cur && !m_max.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+        // Last, so a snapshot never sees more total than bucket counts
+        m_total.fetch_add(1, std::memory_order_release);
+    }
+
+    uint64_t count() const { return m_total.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Copies the current state without blocking writers.
+     * @note Under concurrent recording the copy may include a few samples in counts
+     *       but not yet in total; percentile() tolerates that.
+     */
+    HistogramSnapshot snapshot() const {
+        HistogramSnapshot s;
+        s.total = m_total.load(std::memory_order_acquire);
+        for (size_t i = 0; i < s.counts.size(); ++i) {
+            s.counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        }
+        s.sum = m_sum.load(std::memory_order_relaxed);
+        s.min = m_min.load(std::memory_order_relaxed);
+        s.max = m_max.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    /**
+     * @brief Adds a snapshot (e.g. another thread's histogram) into this one.
+     */
+    void merge(const HistogramSnapshot& other) {
+        for (size_t i = 0; i < other.counts.size(); ++i) {
+            if (other.counts[i]) {
+                m_counts[i].fetch_add(other.counts[i], std::memory_order_relaxed);
+            }
+        }
+        m_sum.fetch_add(other.sum, std::memory_order_relaxed);
+        uint64_t cur = m_min.load(std::memory_order_relaxed);
+        while (other.min < cur && !m_min.compare_exchange_weak(cur, other.min, std::memory_order_relaxed)) {}
+        cur = m_max.load(std::memory_order_relaxed);
+        while (other.max > cur && !m_max.compare_exchange_weak(cur, other.max, std::memory_order_relaxed)) {}
+        m_total.fetch_add(other.total, std::memory_order_release);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, latency::kBuckets> m_counts{};
+    std::atomic<uint64_t> m_total{0};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_min{std::numeric_limits<uint64_t>::max()};
+    std::atomic<uint64_t> m_max{0};
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @namespace logging
+ * @brief Asynchronous spdlog setup with an in-memory ring of recent records.
+ *
+ * Log calls only format into a bounded queue; a background thread writes the
+ * console and the ring. When the queue is full the oldest record is dropped, so
+ * the processing loop never waits on console I/O.
+ */
+namespace logging {
+
+struct Options {
+    size_t queue_size{8192};   // Pending records before the oldest is overrun
+    size_t ring_size{2048};    // Records kept in memory for dump_recent()
+    std::string dump_path{"heartbeat_log_dump.txt"};
+};
+
+/**
+ * @brief Replaces the default logger with the async console + ring logger.
+ * @note Call once, from the main thread, before worker threads start logging.
+ */
+void init(const Options& options);
+
+/**
+ * @brief Writes the newest records from the ring to the configured dump file.
+ * @param limit Maximum number of records, 0 for the whole ring.
+ * @return Number of records written.
+ */
+size_t dump_recent(size_t limit = 0);
+
+/**
+ * @brief Dumps the ring on std::terminate and fatal signals (best effort).
+ */
+void install_crash_handlers();
+
+/**
+ * @brief Flushes pending records and stops the logging thread.
+ */
+void shutdown();
+
+} // namespace logging
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <opencv2/core.hpp>
+
+/**
+ * @class PooledMatAllocator
+ * @brief cv::MatAllocator that recycles buffers by size class instead of returning them to the heap.
+ *
+ * Sizes are rounded up to one of four classes per power of two, so frames of a fixed
+ * resolution keep hitting the same free lists (the warp output, BGRA conversions, resize
+ * targets). Freed buffers stay cached up to `max_cached_bytes`; anything above that, or any
+ * single buffer above kMaxPooledBytes, goes straight back to cv::fastFree.
+ * The UMatData headers are recycled as well, so a steady-state cv::Mat::create costs no malloc.
+ */
+class PooledMatAllocator : public cv::MatAllocator {
+public:
+    static constexpr size_t kMinClassBytes = 64;
+    static constexpr size_t kMaxPooledBytes = size_t{64} << 20;
+
+    struct Stats {
+        uint64_t hits{0};      // Served from a free list
+        uint64_t misses{0};    // Fresh cv::fastMalloc
+        uint64_t evictions{0}; // Freed to the heap because the cache was full (or the buffer oversized)
+        size_t bytes_cached{0};
+        size_t bytes_in_use{0};
+    };
+
+    explicit PooledMatAllocator(size_t max_cached_bytes);
+    ~PooledMatAllocator() override;
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usage_flags) const override;
+    bool allocate(cv::UMatData* u, cv::AccessFlag access_flags, cv::UMatUsageFlags usage_flags) const override;
+    void deallocate(cv::UMatData* u) const override;
+
+    Stats stats() const;
+
+    /**
+     * @brief Returns every cached buffer to the heap (e.g. after a resolution change).
+     */
+    void trim() const;
+
+    /**
+     * @brief Size actually reserved for a request of `bytes`.
+     */
+    static size_t size_class(size_t bytes);
+
+private:
+    size_t m_max_cached;
+    mutable std::mutex m_mtx;
+    mutable std::unordered_map<size_t, std::vector<void*>> m_free; // Keyed by size class
+    mutable std::vector<void*> m_free_headers;                     // Raw storage for UMatData
+    mutable size_t m_bytes_cached{0};
+    mutable std::atomic<uint64_t> m_hits{0};
+    mutable std::atomic<uint64_t> m_misses{0};
+    mutable std::atomic<uint64_t> m_evictions{0};
+    mutable std::atomic<size_t> m_bytes_in_use{0};
+};
+
+namespace mat_pool {
+
+/**
+ * @brief Makes a process-wide PooledMatAllocator the cv::Mat default.
+ *
+ * OpenCV has one default allocator per process, so this covers the processing, HUD and
+ * debug threads alike. The allocator is never destroyed: Mats with static lifetime may
+ * still release into it during exit. Calling again returns the installed instance.
+ */
+PooledMatAllocator& install(size_t max_cached_bytes);
+
+/**
+ * @brief The installed allocator, or nullptr.
+ */
+PooledMatAllocator* installed();
+
+} // namespace mat_pool
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include "Instrumentation.hpp"
+
+/**
+ * @brief Renders all instrumentation state in Prometheus text exposition format (0.0.4).
+ *
+ * Zones become the `heartbeat_stage_duration_seconds` histogram, counters become
+ * `heartbeat_<name>_total` and gauges `heartbeat_<name>`. Only atomics are read.
+ */
+std::string render_prometheus(const instr::StageHistograms& stages);
+
+/**
+ * @class MetricsServer
+ * @brief Minimal HTTP/1.0 server answering GET /metrics on localhost or a Unix socket.
+ */
+class MetricsServer {
+public:
+    struct Options {
+        std::string bind_address{"127.0.0.1"};
+        uint16_t port{9464};
+        std::string unix_socket; // POSIX only; when set, used instead of TCP
+    };
+
+    /**
+     * @brief Binds the socket and starts serving on a background thread.
+     * @return std::expected containing the running server or a bind/listen error.
+     */
+    static std::expected<std::unique_ptr<MetricsServer>, std::string> start(
+        const Options& options, std::shared_ptr<const instr::StageHistograms> stages);
+
+    ~MetricsServer();
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+private:
+    MetricsServer(std::intptr_t listen_socket, std::string unix_path,
+                  std::shared_ptr<const instr::StageHistograms> stages);
+    void serve(std::stop_token st);
+    void handle(std::intptr_t client);
+
+    std::intptr_t m_listen;
+    std::string m_unix_path; // Unlinked on shutdown
+    std::shared_ptr<const instr::StageHistograms> m_stages;
+    std::jthread m_worker;
+};
@@ -1,10 +1,27 @@
 #pragma once
 #include <windows.h>
 #include <opencv2/opencv.hpp>
+#include <array>
 #include <atomic>
-#include <mutex>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <string>
 #include "Config.hpp"
+#include "BpmSparkline.hpp"
+#include "HudCompositor.hpp"
+#include "SpscRing.hpp"
+#include "TripleBuffer.hpp"
+
+struct GDIObjectDeleter {
+    void operator()(HGDIOBJ obj) const { if (obj) DeleteObject(obj); }
+};
+using UniqueGDIObject = std::unique_ptr<std::remove_pointer_t<HGDIOBJ>, GDIObjectDeleter>;
+
+struct DCDeleter {
+    void operator()(HDC dc) const { if (dc) DeleteDC(dc); }
+};
+using UniqueDC = std::unique_ptr<std::remove_pointer_t<HDC>, DCDeleter>;
 
 /**
  * @class Overlay
@@ -34,23 +51,85 @@ public:
     void stop();
 
     /**
-     * @brief Updates the numerical BPM display.
+     * @brief Updates the numerical BPM display of one camera (index into config.cameras).
+     * @note Repaints the text rectangle only if the displayed value changed, and the
+     *       sparkline strip for every estimate of camera 0. One producer thread per camera.
      */
-    void update_bpm(double b);
+    void update_bpm(double b, size_t camera = 0);
 
     /**
-     * @brief Thread-safe update of the display frame.
+     * @brief Downscales the frame to HUD size and hands it to the UI thread without locking.
+     * @note Must only be called from a single producer thread.
      */
     void update_frame(const cv::Mat& f);
 
+    /**
+     * @brief Hands a premultiplied BGRA debug layer (see DebugVisualizer) to the UI thread.
+     * @note Pass an empty Mat to hide it. Must only be called from a single producer thread.
+     */
+    void update_debug_layer(const cv::Mat& layer);
+
+    /**
+     * @brief Sets the action for the hud.hotkey_dump_log hotkey. Runs on the UI thread.
+     * @note Set before run() starts.
+     */
+    void on_dump_log_hotkey(std::function<void()> action) { m_on_dump_log = std::move(action); }
+
+    /**
+     * @brief Sets the action for the hud.hotkey_dump_trace hotkey. Runs on the UI thread.
+     * @note Set before run() starts.
+     */
+    void on_dump_trace_hotkey(std::function<void()> action) { m_on_dump_trace = std::move(action); }
+
     /**
      * @brief Returns whether debug mode is currently toggled on.
      */
     bool is_debug_mode() const { return m_debug_enabled; }
 
+    struct PaintStats {
+        uint64_t requested{0};  // update_* calls that needed a repaint
+        uint64_t paints{0};     // WM_PAINTs actually served after coalescing
+        double avg_paint_us{0.0};
+    };
+
+    /**
+     * @brief Repaint counters and mean paint duration since startup.
+     */
+    PaintStats paint_stats() const;
+
 private:
+    /**
+     * @brief A HUD-sized DIB section the producer writes BGRA pixels into directly.
+     */
+    struct Surface {
+        UniqueGDIObject dib;
+        cv::Mat pixels;   // Header over the DIB bits (cfg.hud.width x cfg.hud.height, CV_8UC4)
+        cv::Size size;    // Valid top-left region written by the producer
+    };
+
     static LRESULT CALLBACK WindowProc(HWND h, UINT m, WPARAM w, LPARAM l);
-    void paint(HDC hdc);
+    void paint(HDC hdc, const RECT& dirty);
+
+    /**
+     * @brief "BPM: 72.4" for a single camera, otherwise one "name: 72.4" line per camera.
+     */
+    std::string bpm_text() const;
+
+    /**
+     * @brief Marks parts of the HUD dirty and wakes the UI thread if nothing was pending.
+     */
+    void request_repaint(uint32_t dirty_bits);
+
+    /**
+     * @brief Turns pending dirty bits into an InvalidateRect, at most once per display refresh.
+     */
+    void flush_repaint();
+
+    /**
+     * @brief Creates the cached font, compositor, memory DC and the window-sized back buffer.
+     * @note Called once at startup and again only when the client area is resized.
+     */
+    void rebuild_gdi_resources(int w, int h);
     
     /**
      * @brief Translates config string (e.g., "Ctrl+Alt+D") into Win32 HotKey flags.
@@ -62,15 +141,56 @@ private:
 
     std::atomic<bool> m_running{true};
     std::atomic<bool> m_debug_enabled{false};
-    std::atomic<double> m_bpm{0.0};
+    std::array<std::atomic<double>, AppConfig::kMaxCameras> m_bpm{}; // Per camera, 0 until the first estimate
     
-    std::mutex m_mtx;
-    cv::Mat m_frame;
+    // HUD-sized BGRA frames: written by update_frame, read by paint
+    TripleBuffer<Surface> m_frames;
+    cv::Mat m_scaled; // Producer scratch for the BGR downscale
+
+    // Premultiplied debug layers drawn over the preview
+    TripleBuffer<cv::Mat> m_debug_layers;
+    bool m_debug_layer_visible{false};
+
+    // Resources owned by the UI thread, built once and reused by every paint
+    UniqueGDIObject m_font;    // Only used to rasterize the compositor's glyph atlas
+    std::unique_ptr<HudCompositor> m_compositor;
+    std::unique_ptr<BpmSparkline> m_sparkline; // Null when hud.sparkline_height is 0
+    UniqueDC m_back_dc;        // Holds the back buffer for the final BitBlt
+    UniqueGDIObject m_back_dib;
+    cv::Mat m_back_pixels;     // Header over m_back_dib bits, the compositor target
+    HGDIOBJ m_back_dc_default{nullptr};
+    int m_back_w{0};
+    int m_back_h{0};
+
+    std::atomic<uint64_t> m_paint_count{0};
+    std::atomic<uint64_t> m_paint_ns{0};
+
+    // Repaint coalescing: producers OR in dirty bits, the UI thread drains them
+    static constexpr uint32_t kDirtyFrame = 0x1;
+    static constexpr uint32_t kDirtyText = 0x2;
+    static constexpr uint32_t kDirtySparkline = 0x4;
+    static constexpr UINT WM_APP_REPAINT = WM_APP + 1;
+    static constexpr UINT_PTR REPAINT_TIMER_ID = 1;
+    std::atomic<uint32_t> m_dirty{0};
+    std::array<std::atomic<int>, AppConfig::kMaxCameras> m_shown_bpm_tenths{}; // -1 = nothing shown yet
+    std::atomic<uint64_t> m_repaint_requests{0};
+    std::chrono::steady_clock::time_point m_last_invalidate{};
+    std::chrono::steady_clock::duration m_refresh_interval{std::chrono::milliseconds(16)};
+    bool m_repaint_timer_armed{false};
+    RECT m_text_rect{};
+    RECT m_sparkline_rect{};
+
+    // BPM estimates on their way to the UI-thread sparkline
+    SpscRing<double, 64> m_bpm_history;
     
     HWND m_hwnd{nullptr};
     HINSTANCE m_hInstance;
     AppConfig m_cfg;
     const int HOTKEY_ID = 101; // Unique ID for this app's hotkey
+    const int HOTKEY_DUMP_LOG_ID = 102;
+    const int HOTKEY_DUMP_TRACE_ID = 103;
+    std::function<void()> m_on_dump_log;
+    std::function<void()> m_on_dump_trace;
     int m_window_w{0};
     int m_window_h{0};
     int m_frame_w{0};
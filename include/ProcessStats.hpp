@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @file ProcessStats.hpp
+ * @brief Process-wide memory figures for benchmarks and tools.
+ */
+namespace process_stats {
+
+/**
+ * @brief Peak resident set size (Windows: peak working set) in bytes, 0 if unavailable.
+ */
+size_t peak_rss_bytes();
+
+/**
+ * @brief Current resident set size (Windows: working set) in bytes, 0 if unavailable.
+ */
+size_t current_rss_bytes();
+
+/**
+ * @brief User plus kernel CPU time consumed by all threads of the process, in seconds.
+ */
+double cpu_seconds();
+
+} // namespace process_stats
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file RoiKernels.hpp
+ * @brief Row kernels behind roi_stats::compute.
+ *
+ * Kept free of OpenCV and standard-library templates: the kernel translation units are compiled
+ * with per-file ISA flags, and any inline function they instantiate could be emitted with those
+ * instructions and picked by the linker for callers running on older CPUs.
+ */
+namespace roi_stats {
+
+/**
+ * @struct Accum
+ * @brief Running totals over the pixels selected by the mask.
+ */
+struct Accum {
+    uint64_t sum[3] = {0, 0, 0};    // B, G, R
+    uint64_t sum_sq[3] = {0, 0, 0}; // B², G², R²
+    uint64_t clipped = 0;           // Pixels with any channel <= clip_lo or >= clip_hi
+    uint64_t count = 0;             // Pixels accumulated
+};
+
+/// Adds `n` BGR pixels (3n bytes) to `acc`; `mask` (n bytes, nonzero = use) may be null.
+using RowKernel = void (*)(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi,
+                           Accum& acc);
+
+namespace detail {
+
+/// pshufb controls: kDeinterleave[ch][s] gathers channel `ch` of 16 pixels from bytes 16s..16s+15
+/// of a 48-byte BGR run (0x80 zeroes the lane); OR the three gathers to get the whole channel.
+alignas(16) inline constexpr uint8_t kDeinterleave[3][3][16] = {
+    {
+        {0, 3, 6, 9, 12, 15, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+        {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 2, 5, 8, 11, 14, 0x80, 0x80, 0x80, 0x80, 0x80},
+        {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 1, 4, 7, 10, 13},
+    },
+    {
+        {1, 4, 7, 10, 13, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+        {0x80, 0x80, 0x80, 0x80, 0x80, 0, 3, 6, 9, 12, 15, 0x80, 0x80, 0x80, 0x80, 0x80},
+        {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 2, 5, 8, 11, 14},
+    },
+    {
+        {2, 5, 8, 11, 14, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+        {0x80, 0x80, 0x80, 0x80, 0x80, 1, 4, 7, 10, 13, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+        {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0, 3, 6, 9, 12, 15},
+    },
+};
+
+/// Squares are summed in 32-bit lanes and widened to 64 bits every this many blocks. A lane takes
+/// four squares per block (two from each pmaddwd/vpadal half), at most 4 * 255² = 260100, so 4096
+/// blocks stay below 1.07e9, under both 2³¹ and 2³².
+inline constexpr size_t kSquareFlushBlocks = 4096;
+
+void accumulate_scalar(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi, Accum& acc);
+void accumulate_sse42(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi, Accum& acc);
+void accumulate_avx2(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi, Accum& acc);
+void accumulate_avx512(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi, Accum& acc);
+void accumulate_neon(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi, Accum& acc);
+} // namespace detail
+
+} // namespace roi_stats
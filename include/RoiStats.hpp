@@ -0,0 +1,55 @@
+#pragma once
+#include <opencv2/core.hpp>
+#include "RoiKernels.hpp"
+
+/**
+ * @file RoiStats.hpp
+ * @brief Integer statistics over interleaved BGR8 ROIs, with SIMD kernels chosen at startup via CPUID.
+ *
+ * Every variant accumulates exact integer sums, so results are bit-identical across
+ * instruction sets. Each kernel lives in its own translation unit compiled with only that
+ * unit's ISA flags (RoiStats*.cpp).
+ */
+namespace roi_stats {
+
+/**
+ * @struct Options
+ * @brief Thresholds for the clipped-pixel count (under/over-exposed skin).
+ */
+struct Options {
+    uint8_t clip_lo = 5;
+    uint8_t clip_hi = 250;
+};
+
+enum class Isa { Scalar, Sse42, Avx2, Avx512, Neon };
+
+const char* isa_name(Isa isa);
+
+/**
+ * @brief Best instruction set this CPU and OS support among the compiled kernels.
+ *
+ * HBM_SIMD=scalar|sse42|avx2|avx512|neon in the environment caps the choice (for A/B runs).
+ */
+Isa active_isa();
+
+/**
+ * @brief Kernel for `isa`, or nullptr when it was not compiled in or the CPU lacks it.
+ */
+RowKernel kernel(Isa isa);
+
+/**
+ * @brief Statistics over a CV_8UC3 image, optionally restricted to a CV_8UC1 mask of the same size.
+ */
+Accum compute(const cv::Mat& bgr, const cv::Mat& mask = cv::Mat(), const Options& options = {});
+
+/**
+ * @brief Per-channel mean, bit-identical to cv::mean over the same pixels.
+ */
+cv::Scalar mean(const Accum& acc);
+
+/**
+ * @brief Per-channel population standard deviation.
+ */
+cv::Scalar stddev(const Accum& acc);
+
+} // namespace roi_stats
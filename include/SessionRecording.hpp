@@ -0,0 +1,153 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @file SessionRecording.hpp
+ * @brief Append-only columnar session files (.hbms): per-frame ROI means, face geometry and stage timings.
+ *
+ * Layout: a fixed file header, then self-contained chunks of up to `chunk_frames` rows.
+ * Each chunk stores one column after another; integer columns are delta + zigzag + varint
+ * coded, floating-point columns XOR their bit pattern with the previous row before varint
+ * coding. Both are lossless, so replayed samples are bit-identical to the recorded ones.
+ * A crash loses at most the chunk in flight; the reader ignores a truncated tail.
+ */
+
+/// Stage timings kept per frame, in SessionFrame::stage_us order
+inline constexpr std::array<const char*, 4> kSessionStages{"capture", "face", "roi", "analyze"};
+
+/**
+ * @struct SessionFrame
+ * @brief One processed camera frame.
+ */
+struct SessionFrame {
+    int64_t t_ns{0};                  // Frame start, steady clock, relative to recording start
+    bool face{false};                 // Analyzer sample taken this frame
+    std::array<double, 3> bgr{};      // Forehead ROI mean (B, G, R); zero without a face
+    std::array<int32_t, 4> box{};     // Face rectangle x, y, width, height in the processed (ROI-cropped) frame
+    std::array<int32_t, 6> anchors{}; // Landmarks 19, 24, 27 (ROI anchors) as x, y pairs
+    double bpm{std::numeric_limits<double>::quiet_NaN()}; // Reported BPM, NaN when none
+    double confidence{0.0};
+    std::array<uint32_t, kSessionStages.size()> stage_us{};
+};
+
+/**
+ * @struct SessionHeader
+ * @brief Analysis settings in effect while recording, so a replay can warn about mismatches.
+ */
+struct SessionHeader {
+    double acquisition_fps{0.0};
+    double window_seconds{0.0};
+    double min_bpm{0.0};
+    double max_bpm{0.0};
+    int64_t start_unix_ns{0};
+};
+
+/**
+ * @class SessionRecorder
+ * @brief Buffers frames on the caller's thread and encodes/writes whole chunks on a background thread.
+ */
+class SessionRecorder {
+public:
+    struct Options {
+        size_t chunk_frames{256};
+        size_t max_pending_chunks{8}; // Beyond this the writer is falling behind; chunks are dropped
+    };
+
+    /**
+     * @brief Creates (truncates) the file and writes its header.
+     * @return std::expected containing the running recorder or an I/O error.
+     */
+    static std::expected<std::unique_ptr<SessionRecorder>, std::string> create(
+        const std::filesystem::path& path, const SessionHeader& header, const Options& options);
+
+    /// Flushes the partial chunk and waits for the writer.
+    ~SessionRecorder();
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    /**
+     * @brief Adds a frame; never blocks on I/O. Single producer.
+     */
+    void append(const SessionFrame& frame);
+
+    uint64_t frames_written() const { return m_frames_written.load(std::memory_order_relaxed); }
+    uint64_t frames_dropped() const { return m_frames_dropped.load(std::memory_order_relaxed); }
+    uint64_t bytes_written() const { return m_bytes_written.load(std::memory_order_relaxed); }
+
+private:
+    SessionRecorder(std::ofstream out, const Options& options);
+    void submit(std::vector<SessionFrame> chunk);
+    void write_loop(std::stop_token st);
+
+    std::ofstream m_out;
+    Options m_options;
+    std::vector<SessionFrame> m_active;
+
+    std::mutex m_mtx;
+    std::condition_variable_any m_cv;
+    std::deque<std::vector<SessionFrame>> m_pending;
+
+    std::atomic<uint64_t> m_frames_written{0};
+    std::atomic<uint64_t> m_frames_dropped{0};
+    std::atomic<uint64_t> m_bytes_written{0};
+    std::jthread m_writer; // Last member: started after, joined before everything above
+};
+
+/**
+ * @class SessionReader
+ * @brief Memory-maps a session file and decodes chunks on demand.
+ */
+class SessionReader {
+public:
+    /**
+     * @brief Maps the file and indexes its chunks.
+     * @return std::expected containing the reader, or an error for a missing file or bad header.
+     */
+    static std::expected<SessionReader, std::string> open(const std::filesystem::path& path);
+
+    const SessionHeader& header() const { return m_header; }
+    size_t chunk_count() const { return m_chunks.size(); }
+    size_t frame_count() const { return m_frames; }
+    size_t file_bytes() const { return m_size; }
+    bool truncated() const { return m_truncated; } // Trailing partial chunk ignored
+
+    /**
+     * @brief Decodes chunk `index`, replacing the contents of `out`.
+     */
+    std::expected<void, std::string> read_chunk(size_t index, std::vector<SessionFrame>& out) const;
+
+    /**
+     * @brief Decodes every chunk in order.
+     */
+    std::expected<std::vector<SessionFrame>, std::string> read_all() const;
+
+private:
+    struct ChunkRef {
+        size_t offset;
+        size_t bytes;
+        uint32_t rows;
+    };
+
+    SessionReader() = default;
+
+    std::shared_ptr<const uint8_t> m_map; // Unmapped by its deleter
+    size_t m_size{0};
+    SessionHeader m_header;
+    std::vector<ChunkRef> m_chunks;
+    size_t m_frames{0};
+    bool m_truncated{false};
+};
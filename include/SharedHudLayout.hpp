@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @file SharedHudLayout.hpp
+ * @brief Binary layout of the shared-memory HUD channel.
+ *
+ * Dependency-free so external consumers can include it on its own. The block is
+ * guarded by a seqlock: the writer makes seq odd, updates the payload, then makes
+ * it even again. Readers retry if seq was odd or changed while they were reading.
+ */
+namespace shm_hud {
+
+inline constexpr uint32_t kMagic = 0x314D4248; // "HBM1"
+inline constexpr uint32_t kVersion = 1;
+inline constexpr char kDefaultName[] = "HeartbeatMonitorHUD";
+
+inline constexpr uint32_t kMaxPreviewWidth = 320;
+inline constexpr uint32_t kMaxPreviewHeight = 180;
+
+/// Set in Header::flags when bpm/confidence hold a valid estimate.
+inline constexpr uint32_t kFlagBpmValid = 0x1;
+/// Set in Header::flags when the preview area holds a BGRA frame.
+inline constexpr uint32_t kFlagPreviewValid = 0x2;
+
+struct alignas(64) Header {
+    uint32_t magic;
+    uint32_t version;
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> flags;
+
+    // Payload fields are atomics accessed relaxed, so torn reads are detected by seq
+    std::atomic<uint64_t> bpm_bits;         // double, bit-cast
+    std::atomic<uint64_t> confidence_bits;  // double in [0, 1], bit-cast
+    std::atomic<int64_t> timestamp_ns;      // steady_clock of the writer, shared by local processes
+    std::atomic<uint64_t> update_count;     // Incremented on every publish
+
+    std::atomic<uint32_t> preview_width;
+    std::atomic<uint32_t> preview_height;
+    std::atomic<uint32_t> preview_stride;   // Bytes per row
+};
+
+struct Block {
+    Header header;
+    alignas(64) uint8_t preview[kMaxPreviewWidth * kMaxPreviewHeight * 4]; // Top-down BGRA
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory atomics must be lock-free to be address-free");
+
+inline constexpr size_t kBlockSize = sizeof(Block);
+
+} // namespace shm_hud
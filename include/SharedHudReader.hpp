@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <string>
+#include "SharedHudLayout.hpp"
+#include "SharedMemory.hpp"
+
+/**
+ * @struct HudSample
+ * @brief A consistent snapshot of the shared HUD header.
+ */
+struct HudSample {
+    bool bpm_valid{false};
+    double bpm{0.0};
+    double confidence{0.0};
+    int64_t timestamp_ns{0};
+    uint64_t update_count{0};
+    uint32_t preview_width{0};
+    uint32_t preview_height{0};
+    uint32_t preview_stride{0};
+};
+
+/**
+ * @class SharedHudReader
+ * @brief Polls the shared-memory HUD channel published by HeartbeatMonitor.
+ *
+ * All reads are plain loads from the mapping: no syscalls, locks or copies of the
+ * preview beyond what the caller's visitor does itself.
+ */
+class SharedHudReader {
+public:
+    /**
+     * @brief Maps the channel read-only.
+     * @return std::expected containing the reader or an error if no writer created it.
+     */
+    static std::expected<SharedHudReader, std::string> open(const std::string& name = shm_hud::kDefaultName);
+
+    /**
+     * @brief Takes a consistent snapshot of the header.
+     * @return false if the writer was mid-update for all retries.
+     */
+    bool read(HudSample& out) const;
+
+    /**
+     * @brief Returns a snapshot only if the writer published since the last call.
+     */
+    std::optional<HudSample> poll();
+
+    /**
+     * @brief Visits the preview pixels in place.
+     * @param visit Callable (const uint8_t* bgra, uint32_t w, uint32_t h, uint32_t stride).
+     * @return true if the visited pixels were not modified while being read.
+     */
+    template <typename F>
+    bool read_preview(F&& visit) const {
+        const auto& h = block().header;
+        const uint32_t s0 = h.seq.load(std::memory_order_acquire);
+        if ((s0 & 1u) || !(h.flags.load(std::memory_order_relaxed) & shm_hud::kFlagPreviewValid)) {
+            return false;
+        }
+        visit(static_cast<const uint8_t*>(block().preview),
+              h.preview_width.load(std::memory_order_relaxed),
+              h.preview_height.load(std::memory_order_relaxed),
+              h.preview_stride.load(std::memory_order_relaxed));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return h.seq.load(std::memory_order_relaxed) == s0;
+    }
+
+private:
+    explicit SharedHudReader(SharedMemoryRegion region) : m_region(std::move(region)) {}
+    const shm_hud::Block& block() const { return *static_cast<const shm_hud::Block*>(m_region.data()); }
+
+    SharedMemoryRegion m_region;
+    uint64_t m_last_update{0};
+};
@@ -0,0 +1,44 @@
+#pragma once
+#include <expected>
+#include <string>
+#include <opencv2/core.hpp>
+#include "SharedHudLayout.hpp"
+#include "SharedMemory.hpp"
+
+/**
+ * @class SharedHudWriter
+ * @brief Publishes BPM, confidence and a downscaled preview to the shared-memory HUD channel.
+ * @note Single writer; readers use SharedHudReader.
+ */
+class SharedHudWriter {
+public:
+    /**
+     * @brief Creates the named channel.
+     * @param preview_size Maximum preview size, clamped to the layout's capacity.
+     */
+    static std::expected<SharedHudWriter, std::string> create(const std::string& name, cv::Size preview_size);
+
+    /**
+     * @brief Publishes a new BPM estimate with its confidence in [0, 1].
+     */
+    void publish_bpm(double bpm, double confidence);
+
+    /**
+     * @brief Area-downscales a BGR frame into the shared preview.
+     */
+    void publish_preview(const cv::Mat& bgr);
+
+private:
+    explicit SharedHudWriter(SharedMemoryRegion region, cv::Size preview_size);
+    shm_hud::Header& header() { return static_cast<shm_hud::Block*>(m_region.data())->header; }
+
+    /**
+     * @brief Runs update inside the seqlock write section.
+     */
+    template <typename F>
+    void write(F&& update);
+
+    SharedMemoryRegion m_region;
+    cv::Size m_preview_size;
+    cv::Mat m_scaled; // BGR scratch outside the write section
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <expected>
+#include <string>
+
+/**
+ * @class SharedMemoryRegion
+ * @brief Named, process-shared memory mapping (Win32 file mapping or POSIX shm).
+ */
+class SharedMemoryRegion {
+public:
+    /**
+     * @brief Creates (or reopens) a read-write region of the given size.
+     */
+    static std::expected<SharedMemoryRegion, std::string> create(const std::string& name, size_t size);
+
+    /**
+     * @brief Maps an existing region read-only.
+     */
+    static std::expected<SharedMemoryRegion, std::string> open_read_only(const std::string& name, size_t size);
+
+    SharedMemoryRegion(SharedMemoryRegion&& other) noexcept;
+    SharedMemoryRegion& operator=(SharedMemoryRegion&& other) noexcept;
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+    ~SharedMemoryRegion();
+
+    void* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    SharedMemoryRegion() = default;
+    void reset();
+
+    void* m_data{nullptr};
+    size_t m_size{0};
+    void* m_handle{nullptr};  // Win32 mapping handle
+    std::string m_unlink_name; // POSIX name to unlink when the owner goes away
+};
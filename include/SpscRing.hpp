@@ -0,0 +1,46 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class SpscRing
+ * @brief Bounded wait-free single-producer / single-consumer queue.
+ * @tparam N Capacity, must be a power of two. A full ring rejects pushes instead of blocking.
+ */
+template <typename T, size_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing capacity must be a power of two");
+
+public:
+    /**
+     * @return false if the ring is full and the value was dropped.
+     */
+    bool try_push(const T& value) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) == N) {
+            return false;
+        }
+        m_items[head & (N - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @return false if the ring is empty.
+     */
+    bool try_pop(T& out) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        out = m_items[tail & (N - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> m_head{0}; // Written by producer
+    alignas(64) std::atomic<size_t> m_tail{0}; // Written by consumer
+    std::array<T, N> m_items{};
+};
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <expected>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Instrumentation.hpp"
+
+/**
+ * @class TraceRecorder
+ * @brief Instrumentation backend that keeps the most recent zone events for trace export.
+ *
+ * Events land in a ring preallocated at construction; once full, the oldest are
+ * overwritten, so a dump always covers the last `capacity` zones across all threads.
+ */
+class TraceRecorder : public instr::Backend {
+public:
+    explicit TraceRecorder(size_t capacity);
+
+    void on_zone(const instr::ThreadBuffer& thread, const instr::ZoneEvent& event) override;
+
+    /**
+     * @brief Writes the buffered events as Chrome Trace Event JSON (chrome://tracing, Perfetto UI).
+     * @return std::expected containing the number of events written or an error.
+     */
+    std::expected<size_t, std::string> write_chrome_json(const std::string& path) const;
+
+private:
+    struct Event {
+        int64_t start_ns;
+        int64_t end_ns;
+        uint32_t thread;
+        instr::ZoneId zone;
+    };
+
+    mutable std::mutex m_mtx;
+    std::vector<Event> m_events;
+    uint64_t m_written{0};
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @class TripleBuffer
+ * @brief Wait-free single-producer / single-consumer handoff of the latest value.
+ *
+ * The producer fills back() and calls publish(); the consumer calls acquire() and
+ * reads front(). The two sides only ever exchange slot indices through one atomic,
+ * so neither waits on the other and unread values are simply overwritten.
+ */
+template <typename T>
+class TripleBuffer {
+public:
+    /**
+     * @brief Producer-owned slot to be filled before publish().
+     */
+    T& back() { return m_slots[m_back]; }
+
+    /**
+     * @brief Hands the back slot to the consumer and takes the stale middle slot in exchange.
+     */
+    void publish() {
+        const uint8_t prev = m_middle.exchange(static_cast<uint8_t>(m_back | kFresh), std::memory_order_acq_rel);
+        m_back = prev & kIndexMask;
+    }
+
+    /**
+     * @brief Swaps in the most recently published slot, if any.
+     * @return true if front() changed since the last call.
+     */
+    bool acquire() {
+        if (!(m_middle.load(std::memory_order_relaxed) & kFresh)) {
+            return false;
+        }
+        const uint8_t prev = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = prev & kIndexMask;
+        return true;
+    }
+
+    /**
+     * @brief Consumer-owned slot holding the latest acquired value.
+     */
+    T& front() { return m_slots[m_front]; }
+    const T& front() const { return m_slots[m_front]; }
+
+    /**
+     * @brief Visits all three slots, e.g. to preallocate them.
+     * @note Only valid while neither side is active.
+     */
+    template <typename F>
+    void for_each(F&& f) {
+        for (auto& slot : m_slots) {
+            f(slot);
+        }
+    }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    std::array<T, 3> m_slots{};
+    uint8_t m_back{0};                 // Producer only
+    std::atomic<uint8_t> m_middle{1};  // Shared: index | kFresh
+    uint8_t m_front{2};                // Consumer only
+};
@@ -0,0 +1,161 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkStealingPool
+ * @brief Task scheduler: a fixed set of workers, each with its own deques, that steal from each other when idle.
+ *
+ * A worker pops its own deque newest-first (the data a task just produced is still in cache)
+ * while thieves and the shared injection queue are served oldest-first. Tasks submitted from
+ * outside the pool, or with inject(), go through the injection queue in FIFO order, which is
+ * what callers use to take turns fairly between independent producers.
+ *
+ * Every queue is split by Priority; a worker takes any High task (its own, injected or stolen)
+ * before any Normal one. Idle workers spin briefly, then park on a condition variable, so an
+ * idle pool costs no CPU; submitters only touch the park lock while someone is parked.
+ */
+class WorkStealingPool {
+public:
+    using Task = std::move_only_function<void()>;
+
+    enum class Priority : uint8_t { High, Normal, Low };
+    static constexpr size_t kPriorities = 3;
+
+    struct Options {
+        unsigned threads{0};                   // 0 = std::thread::hardware_concurrency()
+        bool pin_workers{false};               // Worker i runs only on core (first_core + i) % cores
+        unsigned first_core{0};
+        std::chrono::microseconds spin{50};    // Busy-wait for new work before parking
+        std::string name{"pool"};              // Thread label prefix in traces and logs
+    };
+
+    struct Stats {
+        uint64_t executed{0};
+        uint64_t stolen{0};   // Taken from another worker's deque
+        uint64_t injected{0}; // Went through the shared FIFO
+        uint64_t parks{0};    // Times a worker went to sleep
+    };
+
+    /**
+     * @brief Starts the workers.
+     * @param threads Worker count; 0 uses std::thread::hardware_concurrency().
+     */
+    explicit WorkStealingPool(unsigned threads = 0);
+    explicit WorkStealingPool(const Options& options);
+
+    /**
+     * @brief Runs everything still queued (including tasks those tasks submit), then joins.
+     */
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Queues a task: on the calling worker's own deque, or the injection queue from other threads.
+     */
+    void submit(Task task, Priority priority = Priority::Normal);
+
+    /**
+     * @brief Queues a task behind everything of its priority already in the injection queue.
+     */
+    void inject(Task task, Priority priority = Priority::Normal);
+
+    /**
+     * @brief Runs one queued task on the calling thread, if there is one. Used to help while waiting.
+     * @return true if a task was run.
+     */
+    bool run_one();
+
+    /**
+     * @brief Blocks until no task is queued or running. Must not be called from a worker.
+     */
+    void wait_idle();
+
+    unsigned size() const { return static_cast<unsigned>(m_workers.size()); }
+
+    /**
+     * @brief Index of the calling worker in this pool, or -1 if the caller is not one of them.
+     */
+    int current_worker() const;
+
+    Stats stats() const;
+
+private:
+    struct Worker {
+        std::mutex mtx;
+        std::array<std::deque<Task>, kPriorities> tasks;
+    };
+
+    void enqueue(Task task, int worker, Priority priority);
+    bool try_pop(int self, Task& out);
+    void execute(Task& task);
+    void run(unsigned index);
+
+    Options m_options;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::mutex m_inject_mtx;
+    std::array<std::deque<Task>, kPriorities> m_injected;
+
+    std::array<std::atomic<size_t>, kPriorities> m_queued_at{}; // Lets empty levels be skipped without locking
+    std::atomic<size_t> m_queued{0};  // In some deque
+    std::atomic<size_t> m_pending{0}; // Queued or running
+    std::atomic<unsigned> m_parked{0};
+
+    std::mutex m_park_mtx;
+    std::condition_variable m_wake; // Parked workers wait here for m_queued > 0
+    bool m_stop{false};             // Guarded by m_park_mtx
+
+    std::mutex m_idle_mtx;
+    std::condition_variable m_idle; // wait_idle() waits here for m_pending == 0
+
+    std::atomic<uint64_t> m_executed{0};
+    std::atomic<uint64_t> m_stolen{0};
+    std::atomic<uint64_t> m_injected_count{0};
+    std::atomic<uint64_t> m_parks{0};
+
+    std::vector<std::jthread> m_threads; // Last: joined before the queues above are destroyed
+};
+
+/**
+ * @class TaskGroup
+ * @brief Fork-join helper: tasks run on a pool, wait() returns once all of them have finished.
+ *
+ * Called from a pool worker, wait() keeps running other pool tasks instead of blocking the
+ * worker, so groups can nest (a task may fan out and join its own subtasks).
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(WorkStealingPool& pool, WorkStealingPool::Priority priority = WorkStealingPool::Priority::High);
+
+    /**
+     * @brief Waits for outstanding tasks; a group never outlives the references its tasks captured.
+     */
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    void run(WorkStealingPool::Task task);
+    void wait();
+
+private:
+    void finish_one();
+
+    WorkStealingPool& m_pool;
+    WorkStealingPool::Priority m_priority;
+    std::atomic<size_t> m_remaining{0};
+    std::mutex m_mtx;
+    std::condition_variable m_done;
+};
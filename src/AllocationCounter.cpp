@@ -0,0 +1,91 @@
+#include "AllocationCounter.hpp"
+
+#if HBM_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+thread_local uint64_t t_count = 0; // Trivially initialized: safe to touch from operator new
+std::atomic<uint64_t> g_count{0};
+
+void* counted_alloc(std::size_t size, std::size_t alignment = 0) {
+    ++t_count;
+    g_count.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) {
+        size = 1;
+    }
+#ifdef _WIN32
+    return alignment ? _aligned_malloc(size, alignment) : std::malloc(size);
+#else
+    if (alignment) {
+        void* p = nullptr;
+        return posix_memalign(&p, alignment, size) == 0 ? p : nullptr;
+    }
+    return std::malloc(size);
+#endif
+}
+
+void counted_free(void* p, bool aligned = false) {
+#ifdef _WIN32
+    if (aligned) {
+        _aligned_free(p);
+        return;
+    }
+#else
+    (void)aligned;
+#endif
+    std::free(p);
+}
+
+void* checked(void* p) {
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+} // namespace
+
+void* operator new(std::size_t size) { return checked(counted_alloc(size)); }
+void* operator new[](std::size_t size) { return checked(counted_alloc(size)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size); }
+void* operator new(std::size_t size, std::align_val_t al) {
+    return checked(counted_alloc(size, static_cast<std::size_t>(al)));
+}
+void* operator new[](std::size_t size, std::align_val_t al) {
+    return checked(counted_alloc(size, static_cast<std::size_t>(al)));
+}
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<std::size_t>(al));
+}
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return counted_alloc(size, static_cast<std::size_t>(al));
+}
+
+void operator delete(void* p) noexcept { counted_free(p); }
+void operator delete[](void* p) noexcept { counted_free(p); }
+void operator delete(void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete[](void* p, std::size_t) noexcept { counted_free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { counted_free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { counted_free(p, true); }
+void operator delete[](void* p, std::align_val_t) noexcept { counted_free(p, true); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { counted_free(p, true); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { counted_free(p, true); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(p, true); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { counted_free(p, true); }
+
+namespace alloc_counter {
+uint64_t thread_count() { return t_count; }
+uint64_t total_count() { return g_count.load(std::memory_order_relaxed); }
+} // namespace alloc_counter
+
+#else
+
+namespace alloc_counter {
+uint64_t thread_count() { return 0; }
+uint64_t total_count() { return 0; }
+} // namespace alloc_counter
+
+#endif
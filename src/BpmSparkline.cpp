@@ -0,0 +1,43 @@
+#include "BpmSparkline.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+BpmSparkline::BpmSparkline(cv::Size size, const cv::Scalar& bgr, double min_bpm, double max_bpm)
+    : m_pixels(std::max(2, size.height), std::max(2, size.width), CV_8UC4),
+      m_line(cv::saturate_cast<uint8_t>(bgr[0]), cv::saturate_cast<uint8_t>(bgr[1]),
+             cv::saturate_cast<uint8_t>(bgr[2]), 255),
+      m_backdrop(0, 0, 0, 96),
+      m_min_bpm(min_bpm),
+      m_max_bpm(std::max(max_bpm, min_bpm + 1.0)) {
+    m_pixels.setTo(cv::Scalar(m_backdrop[0], m_backdrop[1], m_backdrop[2], m_backdrop[3]));
+}
+
+int BpmSparkline::to_row(double bpm) const {
+    const double t = std::clamp((bpm - m_min_bpm) / (m_max_bpm - m_min_bpm), 0.0, 1.0);
+    return static_cast<int>(std::lround((1.0 - t) * (m_pixels.rows - 1)));
+}
+
+void BpmSparkline::push(double bpm) {
+    // 1. Scroll: shift every row one pixel left
+    const size_t row_bytes = static_cast<size_t>(m_pixels.cols - 1) * 4;
+    for (int y = 0; y < m_pixels.rows; ++y) {
+        uint8_t* row = m_pixels.ptr<uint8_t>(y);
+        std::memmove(row, row + 4, row_bytes);
+    }
+
+    // 2. Draw only the new rightmost column
+    draw_column(m_pixels.cols - 1, m_has_last ? m_last : bpm, bpm);
+    m_last = bpm;
+    m_has_last = true;
+}
+
+void BpmSparkline::draw_column(int x, double prev, double cur) {
+    const int y0 = to_row(prev);
+    const int y1 = to_row(cur);
+    const int top = std::min(y0, y1);
+    const int bottom = std::max(y0, y1);
+    for (int y = 0; y < m_pixels.rows; ++y) {
+        m_pixels.at<cv::Vec4b>(y, x) = (y >= top && y <= bottom) ? m_line : m_backdrop;
+    }
+}
@@ -0,0 +1,273 @@
+#include "CameraPipeline.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <filesystem>
+#include <stdexcept>
+#include <thread>
+#include <spdlog/spdlog.h>
+#include "AllocationCounter.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+uint32_t us_since(Clock::time_point t0) {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0).count());
+}
+
+int analysis_window(const AppConfig& config, double acquisition_fps) {
+    const double seconds = std::max(1.0, config.analysis.window_duration_seconds);
+    return std::max(2, static_cast<int>(std::lround(seconds * acquisition_fps)));
+}
+
+bool is_device_index(const std::string& source) {
+    return !source.empty() && std::all_of(source.begin(), source.end(), [](unsigned char c) { return std::isdigit(c); });
+}
+} // namespace
+
+CameraPipeline::CameraPipeline(size_t index, const AppConfig::CameraSource& source, const AppConfig& config,
+                               std::shared_ptr<const FaceModel> model, WorkStealingPool& scheduler)
+    : m_index(index),
+      m_source(source),
+      m_min_bpm(config.analysis.min_bpm),
+      m_max_bpm(config.analysis.max_bpm),
+      m_scheduler(scheduler),
+      m_processor(std::move(model)),
+      m_analyzer(analysis_window(config, source.acquisition_fps), source.acquisition_fps),
+      m_interval(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / source.acquisition_fps))) {
+    const auto open_start = Clock::now();
+    const bool device = is_device_index(source.source);
+    if (!(device ? m_cap.open(std::stoi(source.source)) : m_cap.open(source.source))) {
+        throw std::runtime_error("Could not open camera '" + source.name + "' (" + source.source + ")");
+    }
+    std::error_code ec;
+    m_is_file = !device && std::filesystem::is_regular_file(source.source, ec);
+    if (m_is_file) {
+        const double fps = m_cap.get(cv::CAP_PROP_FPS);
+        m_video_fps = fps > 0.0 ? fps : source.fps;
+    } else {
+        if (source.width > 0 && source.height > 0) {
+            m_cap.set(cv::CAP_PROP_FRAME_WIDTH, source.width);
+            m_cap.set(cv::CAP_PROP_FRAME_HEIGHT, source.height);
+        }
+        m_cap.set(cv::CAP_PROP_FPS, source.fps);
+    }
+    if (config.scheduler.parallel_detection) {
+        m_processor.set_scheduler(&m_scheduler);
+    }
+#if HBM_INSTRUMENTATION
+    m_bpm_gauge = instr::register_gauge("camera_" + source.name + "_bpm");
+    m_confidence_gauge = instr::register_gauge("camera_" + source.name + "_confidence");
+    m_face_ratio_gauge = instr::register_gauge("camera_" + source.name + "_face_found_ratio");
+#endif
+    spdlog::info("Camera '{}' ({}) opened in {:.1f} ms: {}x{} @ {:.1f} fps{}, acquisition {:.1f} fps, window {} samples",
+        source.name, source.source, std::chrono::duration<double, std::milli>(Clock::now() - open_start).count(),
+        m_cap.get(cv::CAP_PROP_FRAME_WIDTH), m_cap.get(cv::CAP_PROP_FRAME_HEIGHT),
+        m_is_file ? m_video_fps : m_cap.get(cv::CAP_PROP_FPS), m_is_file ? " (file)" : "",
+        source.acquisition_fps, m_analyzer.window_size());
+}
+
+CameraPipeline::Stats CameraPipeline::stats() const {
+    return {m_frames.load(std::memory_order_relaxed), m_faces.load(std::memory_order_relaxed),
+            m_overruns.load(std::memory_order_relaxed), m_last_bpm.load(std::memory_order_relaxed)};
+}
+
+bool CameraPipeline::read_frame() {
+    HBM_ZONE("capture");
+    if (!m_is_file) {
+        return m_cap.read(m_frame);
+    }
+    // Stand in for a camera: hand out the frame that is current now, waiting if it is not due yet
+    for (;;) {
+        const double t = m_pass_offset + static_cast<double>(m_pass_frames) / m_video_fps;
+        const double now = std::chrono::duration<double>(Clock::now() - m_clock_start).count();
+        const bool stale = t + 1.0 / m_video_fps <= now; // A newer frame has already "arrived"
+        if (!stale && t > now) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(t - now));
+        }
+        if (stale ? m_cap.grab() : m_cap.read(m_frame)) {
+            ++m_pass_frames;
+            if (!stale) {
+                return true;
+            }
+            continue;
+        }
+        if (!m_source.loop || m_pass_frames == 0 || !m_cap.open(m_source.source)) {
+            return false;
+        }
+        m_pass_offset = t;
+        m_pass_frames = 0;
+    }
+}
+
+void CameraPipeline::run(std::stop_token st) {
+    HBM_THREAD_NAME("camera-" + m_source.name);
+    m_clock_start = Clock::now();
+    m_last_stats_log = m_clock_start;
+    m_last_buffer_log = m_clock_start;
+    while (!st.stop_requested()) {
+        const auto frame_start = Clock::now();
+        if (!read_frame()) {
+            spdlog::info("Camera '{}': no more frames", m_source.name);
+            break;
+        }
+        process(frame_start);
+
+        const auto now = Clock::now();
+        const auto elapsed = now - frame_start;
+        if (m_debug.load(std::memory_order_relaxed)) {
+            log_timing(now);
+        }
+        if (elapsed > m_interval) {
+            // Acquisition deadlines that passed while this frame was still being processed
+            HBM_COUNTER_ADD("frame_drops", static_cast<uint64_t>((elapsed + m_interval - std::chrono::nanoseconds(1)) / m_interval) - 1);
+        }
+        if (elapsed > m_interval * 2) {
+            HBM_COUNTER_ADD("overruns", 1);
+            m_overruns.fetch_add(1, std::memory_order_relaxed);
+            spdlog::warn("Camera '{}': frame processing overrun: {:.1f} ms (interval {:.1f} ms)", m_source.name,
+                std::chrono::duration<double, std::milli>(elapsed).count(),
+                std::chrono::duration<double, std::milli>(m_interval).count());
+        } else if (spdlog::should_log(spdlog::level::debug)) {
+            spdlog::debug("Camera '{}': frame processing time: {:.1f} ms", m_source.name,
+                std::chrono::duration<double, std::milli>(elapsed).count());
+        }
+        if (!m_buffer_ready_logged && m_analyzer.buffer_size() >= m_analyzer.window_size()) {
+            spdlog::info("Camera '{}': buffer filled: {} samples", m_source.name, m_analyzer.window_size());
+            m_buffer_ready_logged = true;
+        } else if (!m_buffer_ready_logged && now - m_last_buffer_log > std::chrono::seconds(2)) {
+            const double pct = 100.0 * static_cast<double>(m_analyzer.buffer_size()) /
+                static_cast<double>(std::max<size_t>(1, m_analyzer.window_size()));
+            spdlog::info("Camera '{}': buffering: {}/{} ({:.0f}%)", m_source.name,
+                m_analyzer.buffer_size(), m_analyzer.window_size(), pct);
+            m_last_buffer_log = now;
+        }
+        if (elapsed < m_interval) {
+            std::this_thread::sleep_for(m_interval - elapsed);
+        }
+    }
+    m_finished.store(true, std::memory_order_release);
+}
+
+void CameraPipeline::process(Clock::time_point frame_start) {
+    const uint64_t allocations_at_start = alloc_counter::thread_count();
+    std::array<uint32_t, 4> stage_us{};
+    stage_us[0] = us_since(frame_start);
+    m_frames.fetch_add(1, std::memory_order_relaxed);
+    ++m_window_frames;
+    HBM_COUNTER_ADD("frames", 1);
+    const bool debug = m_debug.load(std::memory_order_relaxed);
+
+    cv::Mat frame = m_frame;
+    if (m_source.frame_roi.area() > 0) {
+        frame = m_frame(m_source.frame_roi & cv::Rect(0, 0, m_frame.cols, m_frame.rows));
+    }
+
+    // The capture hook (HUD and preview copies) overlaps detection; joined before on_result()
+    TaskGroup capture_hook(m_scheduler, WorkStealingPool::Priority::Normal);
+    if (m_on_capture) {
+        capture_hook.run([&] {
+            HBM_ZONE("present");
+            m_on_capture(frame);
+        });
+    }
+
+    const auto face_start = Clock::now();
+    const auto face = m_processor.get_central_face(frame);
+    stage_us[1] = us_since(face_start);
+    m_forehead_corners.release();
+    cv::Scalar avg_bgr;
+    std::optional<double> bpm;
+    if (face) {
+        m_faces.fetch_add(1, std::memory_order_relaxed);
+        ++m_window_faces;
+        HBM_COUNTER_ADD("faces", 1);
+        const auto roi_start = Clock::now();
+        {
+            HBM_ZONE("roi");
+            cv::Mat forehead = m_processor.get_stabilized_forehead(frame, *face, debug ? &m_forehead_corners : nullptr);
+            avg_bgr = m_processor.get_avg_bgr(forehead);
+        }
+        stage_us[2] = us_since(roi_start);
+        const auto analyze_start = Clock::now();
+        {
+            HBM_ZONE("analyze");
+            m_analyzer.add_sample(avg_bgr);
+            if (auto estimate = m_analyzer.calculate_bpm(m_min_bpm, m_max_bpm, debug, m_arena.resource())) {
+                bpm = *estimate;
+            }
+        }
+        stage_us[3] = us_since(analyze_start);
+        if (debug) {
+            const auto now = Clock::now();
+            if (m_last_sample_time) {
+                m_sample_dt_ns.record(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(now - *m_last_sample_time).count()));
+            }
+            m_last_sample_time = now;
+        }
+        if (m_index == 0) {
+            HBM_GAUGE_SET("analyzer_fill", static_cast<double>(m_analyzer.buffer_size()) /
+                static_cast<double>(std::max<size_t>(1, m_analyzer.window_size())));
+        }
+        if (bpm) {
+            m_last_bpm.store(*bpm, std::memory_order_relaxed);
+#if HBM_INSTRUMENTATION
+            instr::set_gauge(m_bpm_gauge, *bpm);
+            instr::set_gauge(m_confidence_gauge, m_analyzer.confidence());
+#endif
+            if (m_index == 0) {
+                HBM_GAUGE_SET("bpm", *bpm);
+                HBM_GAUGE_SET("confidence", m_analyzer.confidence());
+            }
+        }
+    }
+#if HBM_INSTRUMENTATION
+    // Only this thread writes the counters, so relaxed loads see this frame's increments
+    const double face_ratio = static_cast<double>(m_faces.load(std::memory_order_relaxed)) /
+                              static_cast<double>(m_frames.load(std::memory_order_relaxed));
+    instr::set_gauge(m_face_ratio_gauge, face_ratio);
+    if (m_index == 0) {
+        HBM_GAUGE_SET("face_found_ratio", face_ratio);
+    }
+#endif
+
+    // Joined first: the hooks may publish to the same single-writer channel (SharedHudWriter)
+    capture_hook.wait();
+    if (m_on_result) {
+        m_on_result({frame, face, m_forehead_corners, m_analyzer, avg_bgr, bpm, frame_start, stage_us, debug});
+    }
+    m_arena.reset();
+    m_window_allocations += alloc_counter::thread_count() - allocations_at_start;
+}
+
+void CameraPipeline::log_timing(Clock::time_point now) {
+    if (now - m_last_stats_log <= std::chrono::seconds(2) || m_sample_dt_ns.count() <= m_sample_dt_window_start.total + 1) {
+        return;
+    }
+    const HistogramSnapshot dt_session = m_sample_dt_ns.snapshot();
+    const HistogramSnapshot dt_window = dt_session.since(m_sample_dt_window_start);
+    const auto ms = [](uint64_t ns) { return static_cast<double>(ns) / 1e6; };
+    const double target_dt_ms = 1000.0 / m_source.acquisition_fps;
+    const double est_fps = 1e9 / dt_window.mean();
+    const double face_ratio = m_window_frames > 0
+        ? (100.0 * static_cast<double>(m_window_faces) / static_cast<double>(m_window_frames))
+        : 0.0;
+    spdlog::debug("Camera '{}' sample dt ms (target {:.2f}): p50 {:.2f}, p90 {:.2f}, p99 {:.2f}, p99.9 {:.2f}, max {:.2f}, est {:.2f} fps, faces {:.0f}% ({}/{})",
+        m_source.name, target_dt_ms, ms(dt_window.percentile(0.50)), ms(dt_window.percentile(0.90)),
+        ms(dt_window.percentile(0.99)), ms(dt_window.percentile(0.999)), ms(dt_window.max),
+        est_fps, face_ratio, m_window_faces, m_window_frames);
+    spdlog::debug("Camera '{}' sample dt ms (session, n={}): p50 {:.2f}, p99 {:.2f}, p99.9 {:.2f}, max {:.2f}",
+        m_source.name, dt_session.total, ms(dt_session.percentile(0.50)), ms(dt_session.percentile(0.99)),
+        ms(dt_session.percentile(0.999)), ms(dt_session.max));
+    if constexpr (alloc_counter::kEnabled) {
+        spdlog::debug("Camera '{}' operator new per frame (capture..analyze): {:.1f}, arena {} KiB ({} grows)",
+            m_source.name, static_cast<double>(m_window_allocations) / static_cast<double>(std::max<uint64_t>(1, m_window_frames)),
+            m_arena.capacity() / 1024, m_arena.overflows());
+    }
+    m_window_allocations = 0;
+    m_window_frames = 0;
+    m_window_faces = 0;
+    m_last_stats_log = now;
+    m_sample_dt_window_start = dt_session;
+}
@@ -2,6 +2,7 @@
 #include <yaml-cpp/yaml.h>
 #include <filesystem>
 #include <algorithm>
+#include <format>
 
 std::expected<AppConfig, std::string> AppConfig::load(const std::string& path) {
     if (!std::filesystem::exists(path)) {
@@ -16,6 +17,41 @@ std::expected<AppConfig, std::string> AppConfig::load(const std::string& path) {
         auto roi = node["camera"]["frame_roi"].as<std::vector<int>>();
         c.camera.frame_roi = cv::Rect(roi[0], roi[1], roi[2], roi[3]);
 
+        const auto camera_source = [&](const YAML::Node& cam, size_t index) {
+            CameraSource s;
+            s.name = cam["name"].as<std::string>("cam" + std::to_string(index));
+            s.source = cam["source"].as<std::string>(std::to_string(index));
+            s.width = std::max(0, cam["width"].as<int>(0));
+            s.height = std::max(0, cam["height"].as<int>(0));
+            s.fps = cam["fps"].as<double>(c.camera.fps);
+            s.acquisition_fps = std::clamp(cam["acquisition_fps"].as<double>(c.camera.acquisition_fps), 10.0, 60.0);
+            s.frame_roi = c.camera.frame_roi;
+            if (const YAML::Node r = cam["frame_roi"]) {
+                const auto v = r.as<std::vector<int>>();
+                s.frame_roi = cv::Rect(v.at(0), v.at(1), v.at(2), v.at(3));
+            }
+            s.loop = cam["loop"].as<bool>(false);
+            return s;
+        };
+        if (const YAML::Node cams = node["cameras"]) {
+            if (cams.size() > kMaxCameras) {
+                return std::unexpected(std::format("cameras: {} entries, at most {} are supported", cams.size(), kMaxCameras));
+            }
+            for (size_t i = 0; i < cams.size(); ++i) {
+                c.cameras.push_back(camera_source(cams[i], i));
+                // Names label the per-camera metrics and HUD lines, so they must be unique
+                for (size_t j = 0; j < i; ++j) {
+                    if (c.cameras[j].name == c.cameras[i].name) {
+                        return std::unexpected(std::format("cameras: duplicate name '{}' (entries {} and {})",
+                                                           c.cameras[i].name, j, i));
+                    }
+                }
+            }
+        }
+        if (c.cameras.empty()) {
+            c.cameras.push_back(camera_source(YAML::Node(), 0)); // Just the camera section: device 0
+        }
+
         if (node["analysis"] && node["analysis"]["window_duration_seconds"]) {
             c.analysis.window_duration_seconds = node["analysis"]["window_duration_seconds"].as<double>(8.5);
         } else if (node["analysis"] && node["analysis"]["window_size"]) {
@@ -35,12 +71,93 @@ std::expected<AppConfig, std::string> AppConfig::load(const std::string& path) {
         c.hud.font_name = node["hud"]["font_name"].as<std::string>("Arial");
         c.hud.font_size = node["hud"]["font_size"].as<int>(40);
         c.hud.hotkey_toggle_debug = node["hud"]["hotkey_toggle_debug"].as<std::string>("Ctrl+Alt+D");
+        c.hud.sparkline_height = std::max(0, node["hud"]["sparkline_height"].as<int>(40));
+        c.hud.debug_fps = std::clamp(node["hud"]["debug_fps"].as<double>(10.0), 1.0, 60.0);
         std::transform(c.hud.hotkey_toggle_debug.begin(), c.hud.hotkey_toggle_debug.end(), c.hud.hotkey_toggle_debug.begin(),
                                     [](unsigned char c){ return std::toupper(c); }
                                 );
+        c.hud.hotkey_dump_log = node["hud"]["hotkey_dump_log"].as<std::string>("Ctrl+Alt+L");
+        std::transform(c.hud.hotkey_dump_log.begin(), c.hud.hotkey_dump_log.end(), c.hud.hotkey_dump_log.begin(),
+                                    [](unsigned char c){ return std::toupper(c); }
+                                );
+        c.hud.hotkey_dump_trace = node["hud"]["hotkey_dump_trace"].as<std::string>("Ctrl+Alt+T");
+        std::transform(c.hud.hotkey_dump_trace.begin(), c.hud.hotkey_dump_trace.end(), c.hud.hotkey_dump_trace.begin(),
+                                    [](unsigned char c){ return std::toupper(c); }
+                                );
 
         auto col = node["hud"]["color"].as<std::vector<int>>();
         c.hud.r = col[0]; c.hud.g = col[1]; c.hud.b = col[2];
+
+        c.logging.queue_size = 8192;
+        c.logging.ring_size = 2048;
+        c.logging.dump_path = "heartbeat_log_dump.txt";
+        if (const YAML::Node log = node["logging"]) {
+            c.logging.queue_size = std::max(64, log["queue_size"].as<int>(8192));
+            c.logging.ring_size = std::max(16, log["ring_size"].as<int>(2048));
+            c.logging.dump_path = log["dump_path"].as<std::string>(c.logging.dump_path);
+        }
+
+        c.tracing.enabled = false;
+        c.tracing.capacity = 65536;
+        c.tracing.dump_path = "heartbeat_trace.json";
+        c.tracing.dump_on_exit = true;
+        if (const YAML::Node tr = node["tracing"]) {
+            c.tracing.enabled = tr["enabled"].as<bool>(false);
+            c.tracing.capacity = std::max(1024, tr["capacity"].as<int>(65536));
+            c.tracing.dump_path = tr["dump_path"].as<std::string>(c.tracing.dump_path);
+            c.tracing.dump_on_exit = tr["dump_on_exit"].as<bool>(true);
+        }
+
+        c.metrics.enabled = false;
+        c.metrics.bind_address = "127.0.0.1";
+        c.metrics.port = 9464;
+        if (const YAML::Node m = node["metrics"]) {
+            c.metrics.enabled = m["enabled"].as<bool>(false);
+            c.metrics.bind_address = m["bind_address"].as<std::string>(c.metrics.bind_address);
+            c.metrics.port = std::clamp(m["port"].as<int>(9464), 1, 65535);
+            c.metrics.unix_socket = m["unix_socket"].as<std::string>("");
+        }
+
+        c.recording.enabled = false;
+        c.recording.path = "heartbeat_session.hbms";
+        c.recording.chunk_frames = 256;
+        if (const YAML::Node rec = node["recording"]) {
+            c.recording.enabled = rec["enabled"].as<bool>(false);
+            c.recording.path = rec["path"].as<std::string>(c.recording.path);
+            c.recording.chunk_frames = std::max(16, rec["chunk_frames"].as<int>(256));
+        }
+
+        c.scheduler.threads = 2;
+        c.scheduler.pin_workers = false;
+        c.scheduler.first_core = 0;
+        c.scheduler.spin_us = 50;
+        c.scheduler.parallel_detection = false;
+        if (const YAML::Node sch = node["scheduler"]) {
+            c.scheduler.threads = static_cast<unsigned>(std::max(0, sch["threads"].as<int>(2)));
+            c.scheduler.pin_workers = sch["pin_workers"].as<bool>(false);
+            c.scheduler.first_core = static_cast<unsigned>(std::max(0, sch["first_core"].as<int>(0)));
+            c.scheduler.spin_us = std::clamp(sch["spin_us"].as<int>(50), 0, 10000);
+            c.scheduler.parallel_detection = sch["parallel_detection"].as<bool>(false);
+        }
+
+        c.memory.pooled_mats = true;
+        c.memory.mat_pool_max_bytes = size_t{256} << 20;
+        if (const YAML::Node mem = node["memory"]) {
+            c.memory.pooled_mats = mem["pooled_mats"].as<bool>(true);
+            c.memory.mat_pool_max_bytes = static_cast<size_t>(std::max(1, mem["mat_pool_max_mb"].as<int>(256))) << 20;
+        }
+
+        if (const YAML::Node shm = node["shared_memory"]) {
+            c.shared_memory.enabled = shm["enabled"].as<bool>(false);
+            c.shared_memory.name = shm["name"].as<std::string>("HeartbeatMonitorHUD");
+            c.shared_memory.preview_width = std::max(0, shm["preview_width"].as<int>(160));
+            c.shared_memory.preview_height = std::max(0, shm["preview_height"].as<int>(90));
+        } else {
+            c.shared_memory.enabled = false;
+            c.shared_memory.name = "HeartbeatMonitorHUD";
+            c.shared_memory.preview_width = 160;
+            c.shared_memory.preview_height = 90;
+        }
         return c;
     } catch (const std::exception& e) {
         return std::unexpected(e.what());
@@ -0,0 +1,173 @@
+#include "DebugVisualizer.hpp"
+#include "Instrumentation.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+void lower_thread_priority() {
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(__linux__)
+    sched_param param = {};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+}
+} // namespace
+
+namespace debug_viz {
+void plot_signal(std::span<const float> data, cv::Mat& canvas, const cv::Scalar& color) {
+    if (data.size() < 2 || canvas.cols < 2 || canvas.rows < 2) {
+        return;
+    }
+    const auto [min_it, max_it] = std::minmax_element(data.begin(), data.end());
+    float min_v = *min_it;
+    float max_v = *max_it;
+    if (std::fabs(max_v - min_v) < 1e-6f) {
+        max_v = min_v + 1.0f;
+    }
+
+    const int width = canvas.cols;
+    const int height = canvas.rows;
+    auto to_y = [&](float v) {
+        float t = (v - min_v) / (max_v - min_v);
+        return static_cast<int>((1.0f - t) * (height - 1));
+    };
+
+    for (size_t i = 1; i < data.size(); ++i) {
+        int x0 = static_cast<int>((i - 1) * (width - 1) / (data.size() - 1));
+        int x1 = static_cast<int>(i * (width - 1) / (data.size() - 1));
+        cv::line(canvas, cv::Point(x0, to_y(data[i - 1])), cv::Point(x1, to_y(data[i])), color, 1, cv::LINE_AA);
+    }
+}
+} // namespace debug_viz
+
+DebugVisualizer::DebugVisualizer(cv::Size hud_size, double max_fps, LayerSink sink)
+    : m_hud_size(hud_size),
+      m_interval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / std::max(1.0, max_fps)))),
+      m_sink(std::move(sink)),
+      m_worker([this](std::stop_token st) { run(st); }) {}
+
+void DebugVisualizer::submit(cv::Size frame_size, const HeartbeatAnalyzer& analyzer,
+                             const dlib::full_object_detection* landmarks, const cv::Mat* forehead_corners) {
+    // Hot path: only copies into preallocated vectors
+    DebugSnapshot& snap = m_snapshots.back();
+    snap.enabled = true;
+    snap.frame_size = frame_size;
+    snap.signal.assign(analyzer.debug_signal().begin(), analyzer.debug_signal().end());
+    snap.spectrum.assign(analyzer.debug_spectrum().begin(), analyzer.debug_spectrum().end());
+
+    snap.landmarks.clear();
+    snap.face_rect = cv::Rect();
+    if (landmarks) {
+        for (unsigned long i = 0; i < landmarks->num_parts(); ++i) {
+            snap.landmarks.emplace_back(landmarks->part(i).x(), landmarks->part(i).y());
+        }
+        const auto& r = landmarks->get_rect();
+        snap.face_rect = cv::Rect(r.left(), r.top(), r.width(), r.height());
+    }
+    snap.has_forehead = forehead_corners && forehead_corners->total() == snap.forehead.size();
+    if (snap.has_forehead) {
+        for (size_t i = 0; i < snap.forehead.size(); ++i) {
+            snap.forehead[i] = forehead_corners->at<cv::Point>(static_cast<int>(i));
+        }
+    }
+    m_snapshots.publish();
+    m_enabled = true;
+}
+
+void DebugVisualizer::disable() {
+    if (!m_enabled) {
+        return;
+    }
+    m_snapshots.back().enabled = false;
+    m_snapshots.publish();
+    m_enabled = false;
+}
+
+void DebugVisualizer::run(std::stop_token st) {
+    lower_thread_priority();
+    HBM_THREAD_NAME("debug-viz");
+    auto next = std::chrono::steady_clock::now();
+    while (!st.stop_requested()) {
+        next = std::max(next + m_interval, std::chrono::steady_clock::now());
+        {
+            std::unique_lock lock(m_sleep_mtx);
+            m_sleep_cv.wait_until(lock, st, next, [] { return false; });
+        }
+        if (st.stop_requested()) {
+            break;
+        }
+        if (m_snapshots.acquire()) {
+            render(m_snapshots.front());
+        }
+    }
+}
+
+void DebugVisualizer::render(const DebugSnapshot& snap) {
+    if (!snap.enabled || snap.frame_size.empty()) {
+        if (m_visible) {
+            m_sink(cv::Mat());
+            m_visible = false;
+        }
+        return;
+    }
+    HBM_ZONE("debug_render");
+
+    // Same aspect fit as the HUD preview so landmark coordinates line up
+    const double scale = std::min(static_cast<double>(m_hud_size.width) / snap.frame_size.width,
+                                  static_cast<double>(m_hud_size.height) / snap.frame_size.height);
+    const cv::Size size(std::max(1, static_cast<int>(std::lround(snap.frame_size.width * scale))),
+                        std::max(1, static_cast<int>(std::lround(snap.frame_size.height * scale))));
+    m_layer.create(size, CV_8UC4);
+    m_layer.setTo(cv::Scalar::all(0));
+
+    // Opaque colours drawn on a transparent BGRA layer stay premultiplied, AA edges included
+    auto to_hud = [scale](const cv::Point& p) {
+        return cv::Point(static_cast<int>(std::lround(p.x * scale)), static_cast<int>(std::lround(p.y * scale)));
+    };
+    // 1. Landmarks, face box and forehead ROI
+    for (const auto& p : snap.landmarks) {
+        cv::circle(m_layer, to_hud(p), 1, cv::Scalar(0, 255, 255, 255), -1);
+    }
+    if (!snap.face_rect.empty()) {
+        cv::rectangle(m_layer, cv::Rect(to_hud(snap.face_rect.tl()), to_hud(snap.face_rect.br())),
+                      cv::Scalar(255, 0, 0, 255), 1);
+    }
+    if (snap.has_forehead) {
+        std::array<cv::Point, 4> pts;
+        std::transform(snap.forehead.begin(), snap.forehead.end(), pts.begin(), to_hud);
+        cv::polylines(m_layer, pts, true, cv::Scalar(0, 255, 0, 255), 1);
+    }
+
+    // 2. Plots stacked on the right half over a translucent backdrop
+    const int margin = 4;
+    const int plot_w = std::max(2, size.width / 2 - margin);
+    const int plot_h = std::max(2, (size.height - 3 * margin) / 2);
+    int y = margin;
+    const std::pair<const std::vector<float>*, const char*> plots[] = {
+        {&snap.signal, "FFT Input"}, {&snap.spectrum, "FFT Mag"}};
+    for (const auto& [data, label] : plots) {
+        if (data->size() < 2 || y + plot_h > size.height) {
+            continue;
+        }
+        cv::Mat canvas = m_layer(cv::Rect(size.width - plot_w - margin, y, plot_w, plot_h));
+        canvas.setTo(cv::Scalar(0, 0, 0, 160));
+        debug_viz::plot_signal(*data, canvas, cv::Scalar(0, 255, 0, 255));
+        cv::rectangle(canvas, cv::Rect(0, 0, plot_w, plot_h), cv::Scalar(0, 255, 255, 255), 1);
+        cv::putText(canvas, label, cv::Point(4, 12), cv::FONT_HERSHEY_SIMPLEX,
+                    0.35, cv::Scalar(0, 255, 255, 255), 1, cv::LINE_AA);
+        y += plot_h + margin;
+    }
+
+    m_sink(m_layer);
+    m_visible = true;
+}
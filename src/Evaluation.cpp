@@ -0,0 +1,208 @@
+#include "Evaluation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <format>
+#include <numeric>
+#include <sstream>
+
+namespace {
+std::vector<double> parse_numbers(const std::string& line, char sep = ' ') {
+    std::vector<double> out;
+    std::string normalized = line;
+    if (sep != ' ') {
+        std::replace(normalized.begin(), normalized.end(), sep, ' ');
+    }
+    std::istringstream in(normalized);
+    double v = 0.0;
+    while (in >> v) {
+        out.push_back(v);
+    }
+    return out;
+}
+
+std::expected<eval::GroundTruth, std::string> load_dataset2(const std::filesystem::path& file) {
+    std::ifstream in(file);
+    std::string ppg, hr, ts;
+    if (!std::getline(in, ppg) || !std::getline(in, hr) || !std::getline(in, ts)) {
+        return std::unexpected("Expected 3 lines (PPG, HR, time) in " + file.string());
+    }
+    eval::GroundTruth gt;
+    gt.hr_bpm = parse_numbers(hr);
+    gt.time_s = parse_numbers(ts);
+    if (gt.hr_bpm.size() != gt.time_s.size() || gt.hr_bpm.empty()) {
+        return std::unexpected("HR and time rows differ in length in " + file.string());
+    }
+    return gt;
+}
+
+std::expected<eval::GroundTruth, std::string> load_dataset1(const std::filesystem::path& file) {
+    std::ifstream in(file);
+    eval::GroundTruth gt;
+    std::string line;
+    while (std::getline(in, line)) {
+        const auto row = parse_numbers(line, ',');
+        if (row.size() >= 2) {
+            gt.time_s.push_back(row[0] / 1000.0);
+            gt.hr_bpm.push_back(row[1]);
+        }
+    }
+    if (gt.empty()) {
+        return std::unexpected("No rows in " + file.string());
+    }
+    return gt;
+}
+} // namespace
+
+namespace eval {
+
+double GroundTruth::hr_at(double t) const {
+    if (time_s.empty()) {
+        return 0.0;
+    }
+    const auto it = std::lower_bound(time_s.begin(), time_s.end(), t);
+    if (it == time_s.begin()) {
+        return hr_bpm.front();
+    }
+    if (it == time_s.end()) {
+        return hr_bpm.back();
+    }
+    const size_t i = static_cast<size_t>(it - time_s.begin());
+    const double span = time_s[i] - time_s[i - 1];
+    const double w = span > 0.0 ? (t - time_s[i - 1]) / span : 0.0;
+    return hr_bpm[i - 1] + w * (hr_bpm[i] - hr_bpm[i - 1]);
+}
+
+double GroundTruth::mean_hr(double t0, double t1) const {
+    const auto first = std::lower_bound(time_s.begin(), time_s.end(), t0);
+    const auto last = std::upper_bound(first, time_s.end(), t1);
+    if (first == last) {
+        return hr_at(0.5 * (t0 + t1));
+    }
+    const auto begin = hr_bpm.begin() + (first - time_s.begin());
+    const auto end = hr_bpm.begin() + (last - time_s.begin());
+    return std::accumulate(begin, end, 0.0) / static_cast<double>(end - begin);
+}
+
+std::expected<GroundTruth, std::string> load_ground_truth(const std::filesystem::path& subject_dir) {
+    std::expected<GroundTruth, std::string> gt = std::unexpected("No ground_truth.txt or gtdump.xmp in " + subject_dir.string());
+    if (std::filesystem::exists(subject_dir / "ground_truth.txt")) {
+        gt = load_dataset2(subject_dir / "ground_truth.txt");
+    } else if (std::filesystem::exists(subject_dir / "gtdump.xmp")) {
+        gt = load_dataset1(subject_dir / "gtdump.xmp");
+    }
+    if (gt) {
+        // Some recordings restart their clock; sort so hr_at() can bisect
+        std::vector<size_t> order(gt->time_s.size());
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::ranges::stable_sort(order, {}, [&](size_t i) { return gt->time_s[i]; });
+        GroundTruth sorted;
+        for (const size_t i : order) {
+            sorted.time_s.push_back(gt->time_s[i]);
+            sorted.hr_bpm.push_back(gt->hr_bpm[i]);
+        }
+        *gt = std::move(sorted);
+    }
+    return gt;
+}
+
+std::vector<DatasetEntry> discover_ubfc(const std::filesystem::path& root) {
+    std::vector<DatasetEntry> out;
+    std::error_code ec;
+    for (const auto& dir : std::filesystem::directory_iterator(root, ec)) {
+        if (!dir.is_directory()) {
+            continue;
+        }
+        const auto& p = dir.path();
+        if (!std::filesystem::exists(p / "ground_truth.txt") && !std::filesystem::exists(p / "gtdump.xmp")) {
+            continue;
+        }
+        std::filesystem::path video = p / "vid.avi";
+        if (!std::filesystem::exists(video)) {
+            video.clear();
+            for (const auto& f : std::filesystem::directory_iterator(p, ec)) {
+                const auto ext = f.path().extension();
+                if (ext == ".avi" || ext == ".mp4" || ext == ".mkv") {
+                    video = f.path();
+                    break;
+                }
+            }
+        }
+        if (!video.empty()) {
+            out.push_back({p.filename().string(), video, p});
+        }
+    }
+    std::ranges::sort(out, {}, &DatasetEntry::name);
+    return out;
+}
+
+ErrorStats error_stats(std::span<const double> estimate, std::span<const double> reference) {
+    ErrorStats s;
+    s.n = std::min(estimate.size(), reference.size());
+    if (s.n == 0) {
+        return s;
+    }
+    double abs_sum = 0.0, sq_sum = 0.0;
+    double mean_e = 0.0, mean_r = 0.0;
+    for (size_t i = 0; i < s.n; ++i) {
+        const double d = estimate[i] - reference[i];
+        abs_sum += std::abs(d);
+        sq_sum += d * d;
+        mean_e += estimate[i];
+        mean_r += reference[i];
+    }
+    const double n = static_cast<double>(s.n);
+    s.mae = abs_sum / n;
+    s.rmse = std::sqrt(sq_sum / n);
+    mean_e /= n;
+    mean_r /= n;
+    double cov = 0.0, var_e = 0.0, var_r = 0.0;
+    for (size_t i = 0; i < s.n; ++i) {
+        const double de = estimate[i] - mean_e;
+        const double dr = reference[i] - mean_r;
+        cov += de * dr;
+        var_e += de * de;
+        var_r += dr * dr;
+    }
+    s.pearson = (var_e > 0.0 && var_r > 0.0) ? cov / std::sqrt(var_e * var_r) : 0.0;
+    return s;
+}
+
+std::expected<SampleTrace, std::string> load_sample_trace(const std::filesystem::path& file) {
+    std::ifstream in(file);
+    if (!in) {
+        return std::unexpected("Cannot open " + file.string());
+    }
+    SampleTrace trace;
+    std::string line;
+    std::getline(in, line); // header
+    while (std::getline(in, line)) {
+        const auto row = parse_numbers(line, ',');
+        if (row.size() != 5) {
+            return std::unexpected(std::format("Malformed row {} in {}", trace.size() + 2, file.string()));
+        }
+        trace.time_s.push_back(row[0]);
+        trace.face.push_back(row[1] != 0.0);
+        trace.bgr.push_back({row[2], row[3], row[4]});
+    }
+    return trace;
+}
+
+std::expected<void, std::string> save_sample_trace(const SampleTrace& trace, const std::filesystem::path& file) {
+    std::ofstream out(file);
+    if (!out) {
+        return std::unexpected("Cannot write " + file.string());
+    }
+    out << "time_s,face,b,g,r\n";
+    for (size_t i = 0; i < trace.size(); ++i) {
+        // Full round-trip precision so replays match the live pipeline bit for bit
+        out << std::format("{},{},{},{},{}\n", trace.time_s[i], trace.face[i] ? 1 : 0,
+            trace.bgr[i][0], trace.bgr[i][1], trace.bgr[i][2]);
+    }
+    if (!out) {
+        return std::unexpected("Write failed for " + file.string());
+    }
+    return {};
+}
+
+} // namespace eval
@@ -0,0 +1,14 @@
+#include "FaceModel.hpp"
+#include <filesystem>
+#include <stdexcept>
+
+FaceModel::FaceModel(const std::string& model_path) {
+    m_detector = dlib::get_frontal_face_detector();
+    for (unsigned long i = 0; i < m_detector.num_detectors(); ++i) {
+        m_detector_parts.emplace_back(m_detector.get_scanner(), m_detector.get_overlap_tester(), m_detector.get_w(i));
+    }
+    if (!std::filesystem::exists(model_path)) {
+        throw std::runtime_error("Dlib model file not found at: " + model_path);
+    }
+    dlib::deserialize(model_path) >> m_shape_predictor;
+}
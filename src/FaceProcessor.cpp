@@ -1,66 +1,89 @@
 #include "FaceProcessor.hpp"
-#include <dlib/opencv.h>
-#include <filesystem>
-#include <chrono>
-
-FaceProcessor::FaceProcessor(const std::string& model_path) {
-    m_detector = dlib::get_frontal_face_detector();
-    if (!std::filesystem::exists(model_path)) {
-        throw std::runtime_error("Dlib model file not found at: " + model_path);
+#include <algorithm>
+#include "Instrumentation.hpp"
+#include "RoiStats.hpp"
+
+FaceProcessor::FaceProcessor(const std::string& model_path)
+    : FaceProcessor(std::make_shared<const FaceModel>(model_path)) {}
+
+FaceProcessor::FaceProcessor(std::shared_ptr<const FaceModel> model)
+    : m_model(std::move(model)),
+      m_detector(m_model->detector()) {}
+
+void FaceProcessor::set_scheduler(WorkStealingPool* scheduler) {
+    m_scheduler = scheduler;
+    if (m_scheduler && m_parts.empty()) {
+        m_parts = m_model->detector_parts();
+        m_part_detections.resize(m_parts.size());
     }
-    dlib::deserialize(model_path) >> m_shape_predictor;
 }
 
-
-void FaceProcessor::draw_debug(cv::Mat& frame, const dlib::full_object_detection& landmarks, cv::Mat forehead_rect) const {
-    // 1. Draw Landmarks
-    for (unsigned long i = 0; i < landmarks.num_parts(); ++i) {
-        cv::circle(frame, cv::Point(landmarks.part(i).x(), landmarks.part(i).y()), 2, cv::Scalar(0, 255, 255), -1);
-    }
-    // 2. Draw Face Rect (approx from landmarks)
-    cv::Rect face_rect(landmarks.get_rect().left(), landmarks.get_rect().top(), 
-                       landmarks.get_rect().width(), landmarks.get_rect().height());
-    cv::rectangle(frame, face_rect, cv::Scalar(255, 0, 0), 2);
-    // 3. Draw Forehead
-    cv::polylines(frame, forehead_rect, true, cv::Scalar(0, 255, 0), 2);
+std::expected<dlib::full_object_detection, std::string> FaceProcessor::get_central_face(const cv::Mat& frame) {
+    return detect_central_face(frame).transform(
+        [&](const dlib::rectangle& face) { return predict_landmarks(frame, face); });
 }
 
-std::expected<dlib::full_object_detection, std::string> FaceProcessor::get_central_face(
-    const cv::Mat& frame, FaceTimings* timings) {
-    auto to_ms = [](auto d) {
-        return std::chrono::duration<double, std::milli>(d).count();
-    };
-
-    auto t0 = std::chrono::steady_clock::now();
+std::expected<dlib::rectangle, std::string> FaceProcessor::detect_central_face(const cv::Mat& frame) {
     dlib::cv_image<dlib::bgr_pixel> dlib_img(frame);
-    auto faces = m_detector(dlib_img);
-    auto t1 = std::chrono::steady_clock::now();
-    if (timings) {
-        timings->detect_ms = to_ms(t1 - t0);
+    {
+        HBM_ZONE("detect");
+        m_detections.clear(); // Capacity is kept, so steady-state frames don't reallocate it
+        if (m_scheduler && m_parts.size() > 1) {
+            detect_parts(dlib_img);
+        } else {
+            m_detector(dlib_img, m_detections);
+        }
     }
 
-    if (faces.empty()) {
+    if (m_detections.empty()) {
         return std::unexpected("No faces in view");
     }
 
-    auto t2 = std::chrono::steady_clock::now();
     dlib::point frame_center(frame.cols / 2, frame.rows / 2);
     
-    auto closest_face = std::min_element(faces.begin(), faces.end(), [&](const auto& a, const auto& b) {
-        return dlib::length(center(a) - frame_center) < dlib::length(center(b) - frame_center);
+    auto closest_face = std::min_element(m_detections.begin(), m_detections.end(), [&](const auto& a, const auto& b) {
+        return dlib::length(center(a.rect) - frame_center) < dlib::length(center(b.rect) - frame_center);
     });
-    auto t3 = std::chrono::steady_clock::now();
-    if (timings) {
-        timings->select_ms = to_ms(t3 - t2);
+    return closest_face->rect;
+}
+
+void FaceProcessor::detect_parts(const dlib::cv_image<dlib::bgr_pixel>& image) {
+    {
+        TaskGroup group(*m_scheduler);
+        for (size_t i = 0; i < m_parts.size(); ++i) {
+            group.run([this, &image, i] {
+                HBM_ZONE("detect_part");
+                m_part_detections[i].clear();
+                m_parts[i](image, m_part_detections[i]);
+            });
+        }
+        group.wait();
     }
 
-    auto t4 = std::chrono::steady_clock::now();
-    auto landmarks = m_shape_predictor(dlib_img, *closest_face);
-    auto t5 = std::chrono::steady_clock::now();
-    if (timings) {
-        timings->predict_ms = to_ms(t5 - t4);
+    // Same merge as dlib's multi-filter detector: strongest first, drop boxes overlapping a kept one
+    for (size_t i = 0; i < m_part_detections.size(); ++i) {
+        for (dlib::rect_detection det : m_part_detections[i]) {
+            det.weight_index = i;
+            m_detections.push_back(det);
+        }
     }
-    return landmarks;
+    std::stable_sort(m_detections.begin(), m_detections.end(),
+        [](const auto& a, const auto& b) { return a.detection_confidence > b.detection_confidence; });
+    const auto overlaps = m_model->detector().get_overlap_tester();
+    size_t kept = 0;
+    for (size_t i = 0; i < m_detections.size(); ++i) {
+        const bool suppressed = std::any_of(m_detections.begin(), m_detections.begin() + kept,
+            [&](const auto& k) { return overlaps(k.rect, m_detections[i].rect); });
+        if (!suppressed) {
+            m_detections[kept++] = m_detections[i];
+        }
+    }
+    m_detections.resize(kept);
+}
+
+dlib::full_object_detection FaceProcessor::predict_landmarks(const cv::Mat& frame, const dlib::rectangle& face) const {
+    HBM_ZONE("predict");
+    return m_model->shape_predictor()(dlib::cv_image<dlib::bgr_pixel>(frame), face);
 }
 
 cv::Mat FaceProcessor::get_stabilized_forehead(const cv::Mat& frame, const dlib::full_object_detection& landmarks, cv::Mat* out_corners) const
@@ -130,5 +153,8 @@ cv::Mat FaceProcessor::get_stabilized_forehead(const cv::Mat& frame, const dlib:
 }
 
 cv::Scalar FaceProcessor::get_avg_bgr(const cv::Mat& frame) const {
-    return cv::mean(frame);
+    if (frame.type() != CV_8UC3) {
+        return cv::mean(frame);
+    }
+    return roi_stats::mean(roi_stats::compute(frame)); // Same result as cv::mean, on the dispatched kernel
 }
@@ -0,0 +1,29 @@
+#include "FrameArena.hpp"
+
+FrameArena::FrameArena(size_t initial_bytes)
+    : m_capacity(initial_bytes),
+      m_block(new std::byte[initial_bytes]) {
+    m_resource.emplace(m_block.get(), m_capacity, &m_upstream);
+}
+
+void FrameArena::reset() {
+    m_resource->release();
+    if (m_upstream.overflowed) {
+        // Grow so the next frame of the same shape fits entirely in the block
+        m_upstream.overflowed = false;
+        ++m_overflows;
+        m_capacity *= 2;
+        m_resource.reset();
+        m_block.reset(new std::byte[m_capacity]);
+        m_resource.emplace(m_block.get(), m_capacity, &m_upstream);
+    }
+}
+
+void* FrameArena::OverflowTracker::do_allocate(size_t bytes, size_t alignment) {
+    overflowed = true;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void FrameArena::OverflowTracker::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
@@ -6,36 +6,6 @@
 #include <array>
 #include <spdlog/spdlog.h>
 
-namespace {
-cv::Mat plot_signal(const std::vector<float>& data, int width, int height) {
-    if (data.size() < 2) {
-        return cv::Mat();
-    }
-    float min_v = *std::min_element(data.begin(), data.end());
-    float max_v = *std::max_element(data.begin(), data.end());
-    if (std::fabs(max_v - min_v) < 1e-6f) {
-        max_v = min_v + 1.0f;
-    }
-
-    cv::Mat plot(height, width, CV_8UC3, cv::Scalar(0, 0, 0));
-
-    auto to_y = [&](float v) {
-        float t = (v - min_v) / (max_v - min_v);
-        return static_cast<int>((1.0f - t) * (height - 1));
-    };
-
-    for (size_t i = 1; i < data.size(); ++i) {
-        int x0 = static_cast<int>((i - 1) * (width - 1) / (data.size() - 1));
-        int x1 = static_cast<int>(i * (width - 1) / (data.size() - 1));
-        int y0 = to_y(data[i - 1]);
-        int y1 = to_y(data[i]);
-        cv::line(plot, cv::Point(x0, y0), cv::Point(x1, y1), cv::Scalar(0, 255, 0), 1, cv::LINE_AA);
-    }
-
-    return plot;
-}
-} // namespace
-
 HeartbeatAnalyzer::HeartbeatAnalyzer(int window_size, double fps) 
     : m_ws(window_size), m_fps(fps) {}
 
@@ -44,17 +14,19 @@ void HeartbeatAnalyzer::add_sample(const cv::Scalar& bgr) {
     if (m_buffer.size() > m_ws) m_buffer.pop_front();
 }
 
-std::expected<double, std::string> HeartbeatAnalyzer::calculate_bpm(double min_b, double max_b, bool debug_plot) {
+std::expected<double, std::string> HeartbeatAnalyzer::calculate_bpm(double min_b, double max_b, bool debug_capture,
+                                                                   std::pmr::memory_resource* scratch) {
     if (m_buffer.size() < m_ws) return std::unexpected("Buffering...");
 
     // 1. Extract R, G, B channels
-    std::vector<double> R, G, B;
+    std::pmr::vector<double> R(scratch), G(scratch), B(scratch);
+    R.reserve(m_ws); G.reserve(m_ws); B.reserve(m_ws);
     for (const auto& s : m_buffer) {
         B.push_back(s[0]); G.push_back(s[1]); R.push_back(s[2]);
     }
 
     // 2. Temporal Normalization (Mean centering)
-    auto normalize = [](std::vector<double>& vec) {
+    auto normalize = [](std::pmr::vector<double>& vec) {
         const double sum = std::accumulate(vec.begin(), vec.end(), 0.0);
         const double mean = sum / static_cast<double>(vec.size());
         for (auto& v : vec) {
@@ -66,14 +38,14 @@ std::expected<double, std::string> HeartbeatAnalyzer::calculate_bpm(double min_b
     // 3. POS Projections
     // S1 = G - B
     // S2 = G + B - 2R
-    std::vector<double> S1(m_ws), S2(m_ws);
+    std::pmr::vector<double> S1(m_ws, scratch), S2(m_ws, scratch);
     for (size_t i = 0; i < m_ws; ++i) {
         S1[i] = G[i] - B[i];
         S2[i] = G[i] + B[i] - 2.0 * R[i];
     }
 
     // 4. Calculate Alpha (Ratio of standard deviations)
-    auto get_std = [](const std::vector<double>& v) {
+    auto get_std = [](const std::pmr::vector<double>& v) {
         double mean = std::accumulate(v.begin(), v.end(), 0.0) / v.size();
         double sq_sum = std::inner_product(v.begin(), v.end(), v.begin(), 0.0);
         return std::sqrt(sq_sum / v.size() - mean * mean);
@@ -81,7 +53,7 @@ std::expected<double, std::string> HeartbeatAnalyzer::calculate_bpm(double min_b
     double alpha = get_std(S1) / (get_std(S2) + 1e-6);
 
     // 5. Final POS Signal: H = S1 + alpha * S2
-    std::vector<float> H(m_ws);
+    std::pmr::vector<float> H(m_ws, scratch);
     for (size_t i = 0; i < m_ws; ++i) {
         H[i] = static_cast<float>(S1[i] + alpha * S2[i]);
     }
@@ -95,27 +67,23 @@ std::expected<double, std::string> HeartbeatAnalyzer::calculate_bpm(double min_b
         H[i] *= 0.54f - 0.46f * cosf(2.0f * (float)CV_PI * i / (m_ws - 1));
     }
 
-    if (debug_plot) {
-        m_debug_fft_input = plot_signal(H, 320, 160);
+    if (debug_capture) {
+        m_debug_signal.assign(H.begin(), H.end());
     } else {
-        m_debug_fft_input.release();
-        m_debug_fft_magnitude.release();
+        m_debug_signal.clear();
+        m_debug_spectrum.clear();
     }
 
     // 7. FFT Analysis
-    cv::Mat planes[] = { cv::Mat_<float>(H), cv::Mat::zeros((int)m_ws, 1, CV_32F) }, complex;
+    cv::Mat planes[] = { cv::Mat((int)m_ws, 1, CV_32F, H.data()), cv::Mat::zeros((int)m_ws, 1, CV_32F) }, complex;
     cv::merge(planes, 2, complex);
     cv::dft(complex, complex);
     cv::split(complex, planes);
     cv::magnitude(planes[0], planes[1], planes[0]);
 
-    if (debug_plot) {
-        std::vector<float> mag;
-        mag.reserve(m_ws / 2);
-        for (int i = 0; i < (int)m_ws / 2; ++i) {
-            mag.push_back(planes[0].at<float>(i));
-        }
-        m_debug_fft_magnitude = plot_signal(mag, 320, 160);
+    if (debug_capture) {
+        const float* mag = planes[0].ptr<float>();
+        m_debug_spectrum.assign(mag, mag + m_ws / 2);
     }
 
     // 8. Peak detection in human heart range
@@ -131,15 +99,27 @@ std::expected<double, std::string> HeartbeatAnalyzer::calculate_bpm(double min_b
     low = std::clamp(low, 1, max_bin);
     high = std::clamp(high, low, max_bin);
     int peak = -1; float max_v = -1.0f;
+    double band_power = 0.0;
 
     for (int i = low; i <= high && i < (int)m_ws / 2; ++i) {
-        if (planes[0].at<float>(i) > max_v) {
-            max_v = planes[0].at<float>(i);
+        const float v = planes[0].at<float>(i);
+        band_power += static_cast<double>(v) * v;
+        if (v > max_v) {
+            max_v = v;
             peak = i;
         }
     }
+    m_confidence = 0.0;
+    if (peak > 0 && band_power > 0.0) {
+        double peak_power = 0.0;
+        for (int i = std::max(low, peak - 1); i <= std::min(high, peak + 1); ++i) {
+            const float v = planes[0].at<float>(i);
+            peak_power += static_cast<double>(v) * v;
+        }
+        m_confidence = peak_power / band_power;
+    }
 
-    if (debug_plot) {
+    if (debug_capture) {
         struct Peak { int idx; float mag; };
         std::array<Peak, 3> top{{{-1, -1.0f}, {-1, -1.0f}, {-1, -1.0f}}};
         for (int i = low; i <= high && i < (int)m_ws / 2; ++i) {
@@ -0,0 +1,283 @@
+#include "HudCompositor.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HBM_BLEND_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HBM_BLEND_NEON 1
+#endif
+
+namespace {
+// Exact round(x / 255) for x in [0, 255 * 255]
+inline uint32_t div255(uint32_t x) {
+    x += 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+void blend_row_scalar(const uint8_t* s, uint8_t* d, int pixels) {
+    for (int i = 0; i < pixels; ++i, s += 4, d += 4) {
+        const uint32_t inv = 255u - s[3];
+        for (int c = 0; c < 4; ++c) {
+            d[c] = static_cast<uint8_t>(std::min<uint32_t>(255u, s[c] + div255(d[c] * inv)));
+        }
+    }
+}
+
+#if defined(HBM_BLEND_SSE2)
+inline __m128i div255_epu16(__m128i x) {
+    x = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+void blend_row(const uint8_t* s, uint8_t* d, int pixels) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi8(-1);
+    int i = 0;
+    for (; i + 4 <= pixels; i += 4, s += 16, d += 16) {
+        const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        const __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(d));
+        // Broadcast each pixel's alpha to its four bytes, then invert
+        __m128i a = _mm_srli_epi32(src, 24);
+        a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+        a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+        const __m128i inv = _mm_xor_si128(a, ones);
+
+        const __m128i lo = div255_epu16(_mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), _mm_unpacklo_epi8(inv, zero)));
+        const __m128i hi = div255_epu16(_mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), _mm_unpackhi_epi8(inv, zero)));
+        const __m128i out = _mm_adds_epu8(src, _mm_packus_epi16(lo, hi));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), out);
+    }
+    blend_row_scalar(s, d, pixels - i);
+}
+#elif defined(HBM_BLEND_NEON)
+inline uint8x8_t blend_half(uint8x8_t src, uint8x8_t dst, uint8x8_t inv) {
+    const uint16x8_t p = vmull_u8(dst, inv);
+    // (p + 128 + ((p + 128) >> 8)) >> 8, matching div255()
+    const uint16x8_t q = vrshrq_n_u16(vrsraq_n_u16(p, p, 8), 8);
+    return vqadd_u8(src, vmovn_u16(q));
+}
+
+void blend_row(const uint8_t* s, uint8_t* d, int pixels) {
+    int i = 0;
+    for (; i + 8 <= pixels; i += 8, s += 32, d += 32) {
+        const uint8x8x4_t src = vld4_u8(s);
+        uint8x8x4_t dst = vld4_u8(d);
+        const uint8x8_t inv = vmvn_u8(src.val[3]);
+        for (int c = 0; c < 4; ++c) {
+            dst.val[c] = blend_half(src.val[c], dst.val[c], inv);
+        }
+        vst4_u8(d, dst);
+    }
+    blend_row_scalar(s, d, pixels - i);
+}
+#else
+void blend_row(const uint8_t* s, uint8_t* d, int pixels) {
+    blend_row_scalar(s, d, pixels);
+}
+#endif
+
+cv::Mat premultiply_coverage(const cv::Mat& coverage, const cv::Scalar& bgr) {
+    cv::Mat out(coverage.size(), CV_8UC4);
+    const uint32_t b = cv::saturate_cast<uint8_t>(bgr[0]);
+    const uint32_t g = cv::saturate_cast<uint8_t>(bgr[1]);
+    const uint32_t r = cv::saturate_cast<uint8_t>(bgr[2]);
+    for (int y = 0; y < coverage.rows; ++y) {
+        const uint8_t* c = coverage.ptr<uint8_t>(y);
+        uint8_t* o = out.ptr<uint8_t>(y);
+        for (int x = 0; x < coverage.cols; ++x, o += 4) {
+            o[0] = static_cast<uint8_t>(div255(b * c[x]));
+            o[1] = static_cast<uint8_t>(div255(g * c[x]));
+            o[2] = static_cast<uint8_t>(div255(r * c[x]));
+            o[3] = c[x];
+        }
+    }
+    return out;
+}
+} // namespace
+
+namespace hud {
+void blend_premultiplied(const cv::Mat& src, cv::Mat& dst) {
+    CV_Assert(src.type() == CV_8UC4 && dst.type() == CV_8UC4 && src.size() == dst.size());
+    for (int y = 0; y < src.rows; ++y) {
+        blend_row(src.ptr<uint8_t>(y), dst.ptr<uint8_t>(y), src.cols);
+    }
+}
+
+void blend_premultiplied_scalar(const cv::Mat& src, cv::Mat& dst) {
+    CV_Assert(src.type() == CV_8UC4 && dst.type() == CV_8UC4 && src.size() == dst.size());
+    for (int y = 0; y < src.rows; ++y) {
+        blend_row_scalar(src.ptr<uint8_t>(y), dst.ptr<uint8_t>(y), src.cols);
+    }
+}
+
+void blend_premultiplied_at(const cv::Mat& src, cv::Mat& dst, cv::Point origin) {
+    if (src.empty() || dst.empty()) {
+        return;
+    }
+    const cv::Rect dst_rect = cv::Rect(origin, src.size()) & cv::Rect(0, 0, dst.cols, dst.rows);
+    if (dst_rect.empty()) {
+        return;
+    }
+    const cv::Rect src_rect(dst_rect.tl() - origin, dst_rect.size());
+    cv::Mat dst_roi = dst(dst_rect);
+    blend_premultiplied(src(src_rect), dst_roi);
+}
+
+void to_premultiplied(const cv::Mat& bgr, uint8_t alpha, cv::Mat& out) {
+    CV_Assert(bgr.type() == CV_8UC3);
+    out.create(bgr.size(), CV_8UC4);
+    for (int y = 0; y < bgr.rows; ++y) {
+        const uint8_t* s = bgr.ptr<uint8_t>(y);
+        uint8_t* o = out.ptr<uint8_t>(y);
+        for (int x = 0; x < bgr.cols; ++x, s += 3, o += 4) {
+            o[0] = static_cast<uint8_t>(div255(s[0] * alpha));
+            o[1] = static_cast<uint8_t>(div255(s[1] * alpha));
+            o[2] = static_cast<uint8_t>(div255(s[2] * alpha));
+            o[3] = alpha;
+        }
+    }
+}
+
+cv::Size fit_frame_bgra(const cv::Mat& bgr, cv::Size max_size, cv::Mat& scratch, cv::Mat& target) {
+    CV_Assert(target.type() == CV_8UC4 && target.cols >= max_size.width && target.rows >= max_size.height);
+    const double scale = std::min(static_cast<double>(max_size.width) / bgr.cols,
+                                  static_cast<double>(max_size.height) / bgr.rows);
+    const cv::Size fitted(std::max(1, static_cast<int>(std::lround(bgr.cols * scale))),
+                          std::max(1, static_cast<int>(std::lround(bgr.rows * scale))));
+    // Downscale first so the BGRA conversion only touches HUD-sized pixels,
+    // then convert straight into the target's memory.
+    cv::resize(bgr, scratch, fitted, 0, 0, cv::INTER_AREA);
+    cv::Mat dst = target(cv::Rect(cv::Point(0, 0), fitted));
+    cv::cvtColor(scratch, dst, cv::COLOR_BGR2BGRA);
+    return fitted;
+}
+} // namespace hud
+
+GlyphAtlas GlyphAtlas::pack(const std::vector<std::pair<char, cv::Mat>>& cells) {
+    GlyphAtlas atlas;
+    int total_w = 0;
+    for (const auto& [ch, cell] : cells) {
+        CV_Assert(cell.type() == CV_8UC1);
+        atlas.line_height = std::max(atlas.line_height, cell.rows);
+        total_w += cell.cols;
+    }
+    atlas.coverage = cv::Mat::zeros(std::max(1, atlas.line_height), std::max(1, total_w), CV_8UC1);
+
+    int x = 0;
+    for (const auto& [ch, cell] : cells) {
+        const auto idx = static_cast<unsigned char>(ch);
+        if (idx >= atlas.glyphs.size()) {
+            continue;
+        }
+        cell.copyTo(atlas.coverage(cv::Rect(x, 0, cell.cols, cell.rows)));
+        atlas.glyphs[idx] = {cv::Rect(x, 0, cell.cols, atlas.line_height), cell.cols};
+        x += cell.cols;
+    }
+    return atlas;
+}
+
+GlyphAtlas GlyphAtlas::rasterize_hershey(std::string_view charset, int pixel_height) {
+    const int face = cv::FONT_HERSHEY_SIMPLEX;
+    const int thickness = std::max(1, pixel_height / 12);
+    const double scale = cv::getFontScaleFromHeight(face, std::max(1, pixel_height), thickness);
+
+    int ascent = 0;
+    int descent = 0;
+    for (char ch : charset) {
+        int baseline = 0;
+        const cv::Size sz = cv::getTextSize(std::string(1, ch), face, scale, thickness, &baseline);
+        ascent = std::max(ascent, sz.height);
+        descent = std::max(descent, baseline);
+    }
+    const int line_height = ascent + descent + thickness;
+
+    std::vector<std::pair<char, cv::Mat>> cells;
+    cells.reserve(charset.size());
+    for (char ch : charset) {
+        int baseline = 0;
+        const std::string s(1, ch);
+        const cv::Size sz = cv::getTextSize(s, face, scale, thickness, &baseline);
+        cv::Mat cell = cv::Mat::zeros(line_height, std::max(1, sz.width + thickness), CV_8UC1);
+        cv::putText(cell, s, cv::Point(0, ascent), face, scale, cv::Scalar(255), thickness, cv::LINE_AA);
+        cells.emplace_back(ch, std::move(cell));
+    }
+    return pack(cells);
+}
+
+HudCompositor::HudCompositor(GlyphAtlas atlas, const cv::Scalar& text_bgr)
+    : m_atlas(std::move(atlas)) {
+    m_text_fg = premultiply_coverage(m_atlas.coverage, text_bgr);
+    m_text_shadow = premultiply_coverage(m_atlas.coverage, cv::Scalar(0, 0, 0));
+}
+
+void HudCompositor::compose(cv::Mat& target, const cv::Mat& frame, std::span<const HudLayer> layers,
+                            std::string_view text) const {
+    CV_Assert(target.type() == CV_8UC4);
+    // 1. Frame preview (opaque, so a copy rather than a blend)
+    if (frame.empty()) {
+        target.setTo(cv::Scalar::all(0));
+    } else if (frame.size() == target.size()) {
+        frame.copyTo(target);
+    } else {
+        cv::resize(frame, target, target.size(), 0, 0, cv::INTER_NEAREST);
+    }
+
+    // 2. Premultiplied overlays (debug plots etc.)
+    for (const auto& layer : layers) {
+        if (layer.bgra) {
+            hud::blend_premultiplied_at(*layer.bgra, target, layer.origin);
+        }
+    }
+
+    // 3. Text
+    draw_text(target, cv::Point(0, 0), text);
+}
+
+void HudCompositor::draw_text(cv::Mat& target, cv::Point origin, std::string_view text) const {
+    blit_glyphs(target, origin + cv::Point(2, 2), text, m_text_shadow);
+    blit_glyphs(target, origin, text, m_text_fg);
+}
+
+cv::Size HudCompositor::measure(std::string_view text) const {
+    int w = 0;
+    int line_w = 0;
+    int lines = 1;
+    for (char ch : text) {
+        if (ch == '\n') {
+            ++lines;
+            line_w = 0;
+            continue;
+        }
+        const auto idx = static_cast<unsigned char>(ch);
+        if (idx < m_atlas.glyphs.size()) {
+            line_w += m_atlas.glyphs[idx].advance;
+            w = std::max(w, line_w);
+        }
+    }
+    return {w + 2, lines * m_atlas.line_height + 2};
+}
+
+void HudCompositor::blit_glyphs(cv::Mat& target, cv::Point origin, std::string_view text,
+                                const cv::Mat& glyphs) const {
+    cv::Point pen = origin;
+    for (char ch : text) {
+        if (ch == '\n') {
+            pen = {origin.x, pen.y + m_atlas.line_height};
+            continue;
+        }
+        const auto idx = static_cast<unsigned char>(ch);
+        if (idx >= m_atlas.glyphs.size()) {
+            continue;
+        }
+        const auto& glyph = m_atlas.glyphs[idx];
+        if (!glyph.cell.empty() && ch != ' ') {
+            hud::blend_premultiplied_at(glyphs(glyph.cell), target, pen);
+        }
+        pen.x += glyph.advance;
+    }
+}
@@ -0,0 +1,209 @@
+#include "Instrumentation.hpp"
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <spdlog/spdlog.h>
+
+namespace {
+template <size_t N>
+struct NameTable {
+    std::mutex mtx;
+    std::array<std::string, N> names;
+    std::atomic<size_t> count{0};
+
+    uint16_t intern(std::string_view name) {
+        std::lock_guard lock(mtx);
+        const size_t n = count.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            if (names[i] == name) {
+                return static_cast<uint16_t>(i);
+            }
+        }
+        if (n == N) {
+            // Full: fold everything else into the last slot rather than failing inside a macro
+            names[N - 1] = "other";
+            return static_cast<uint16_t>(N - 1);
+        }
+        names[n] = name;
+        count.store(n + 1, std::memory_order_release);
+        return static_cast<uint16_t>(n);
+    }
+};
+
+NameTable<instr::kMaxZones>& zone_table() {
+    static NameTable<instr::kMaxZones> table;
+    return table;
+}
+
+NameTable<instr::kMaxCounters>& counter_table() {
+    static NameTable<instr::kMaxCounters> table;
+    return table;
+}
+
+NameTable<instr::kMaxGauges>& gauge_table() {
+    static NameTable<instr::kMaxGauges> table;
+    return table;
+}
+
+std::array<std::atomic<uint64_t>, instr::kMaxGauges> g_gauges{};
+
+struct ThreadRegistry {
+    std::mutex mtx;
+    std::vector<std::shared_ptr<instr::ThreadBuffer>> buffers;
+};
+
+ThreadRegistry& thread_registry() {
+    static ThreadRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<instr::ThreadBuffer> make_thread_buffer() {
+    auto buffer = std::make_shared<instr::ThreadBuffer>();
+    buffer->os_id = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    auto& registry = thread_registry();
+    std::lock_guard lock(registry.mtx);
+    buffer->index = static_cast<uint32_t>(registry.buffers.size());
+    buffer->name = "thread-" + std::to_string(buffer->index);
+    registry.buffers.push_back(buffer);
+    return buffer;
+}
+} // namespace
+
+namespace instr {
+
+ZoneId register_zone(std::string_view name) { return zone_table().intern(name); }
+CounterId register_counter(std::string_view name) { return counter_table().intern(name); }
+GaugeId register_gauge(std::string_view name) { return gauge_table().intern(name); }
+
+std::string_view zone_name(ZoneId id) { return zone_table().names[id]; }
+std::string_view counter_name(CounterId id) { return counter_table().names[id]; }
+std::string_view gauge_name(GaugeId id) { return gauge_table().names[id]; }
+
+size_t zone_count() { return zone_table().count.load(std::memory_order_acquire); }
+size_t counter_count() { return counter_table().count.load(std::memory_order_acquire); }
+size_t gauge_count() { return gauge_table().count.load(std::memory_order_acquire); }
+
+ThreadBuffer& this_thread_buffer() {
+    // The registry keeps a reference, so events survive the thread's exit until drained
+    thread_local std::shared_ptr<ThreadBuffer> buffer = make_thread_buffer();
+    return *buffer;
+}
+
+void set_thread_name(std::string_view name) {
+    ThreadBuffer& buffer = this_thread_buffer();
+    std::lock_guard lock(thread_registry().mtx);
+    buffer.name = name;
+}
+
+std::string thread_name(const ThreadBuffer& thread) {
+    std::lock_guard lock(thread_registry().mtx);
+    return thread.name;
+}
+
+std::vector<std::shared_ptr<ThreadBuffer>> threads() {
+    auto& registry = thread_registry();
+    std::lock_guard lock(registry.mtx);
+    return registry.buffers;
+}
+
+uint64_t counter_total(CounterId id) {
+    uint64_t total = 0;
+    for (const auto& buffer : threads()) {
+        total += buffer->counters[id].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void set_gauge(GaugeId id, double value) {
+    g_gauges[id].store(std::bit_cast<uint64_t>(value), std::memory_order_relaxed);
+}
+
+double gauge_value(GaugeId id) {
+    return std::bit_cast<double>(g_gauges[id].load(std::memory_order_relaxed));
+}
+
+Collector::Collector(std::chrono::milliseconds period) : m_period(period) {
+    m_worker = std::jthread([this](std::stop_token stop) {
+        HBM_THREAD_NAME("instr-collector");
+        while (!stop.stop_requested()) {
+            std::this_thread::sleep_for(m_period);
+            drain();
+        }
+    });
+}
+
+Collector::~Collector() {
+    m_worker.request_stop();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+    drain();
+}
+
+void Collector::add_backend(std::shared_ptr<Backend> backend) {
+    std::lock_guard lock(m_mtx);
+    m_backends.push_back(std::move(backend));
+}
+
+void Collector::drain() {
+    std::lock_guard lock(m_mtx);
+    const auto buffers = threads();
+    ZoneEvent event;
+    for (const auto& buffer : buffers) {
+        while (buffer->zones.try_pop(event)) {
+            for (const auto& backend : m_backends) {
+                backend->on_zone(*buffer, event);
+            }
+        }
+    }
+    const int64_t now = now_ns();
+    for (const auto& backend : m_backends) {
+        backend->on_tick(now);
+    }
+}
+
+void StageHistograms::on_zone(const ThreadBuffer& /*thread*/, const ZoneEvent& event) {
+    m_zones[event.zone].record(static_cast<uint64_t>(std::max<int64_t>(0, event.end_ns - event.start_ns)));
+}
+
+LogBackend::LogBackend(std::shared_ptr<const StageHistograms> stages, std::chrono::milliseconds interval)
+    : m_stages(std::move(stages)),
+      m_window_start(kMaxZones),
+      m_interval_ns(std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count()),
+      m_last_log_ns(now_ns()) {}
+
+void LogBackend::on_tick(int64_t now_ns) {
+    if (now_ns - m_last_log_ns < m_interval_ns) {
+        return;
+    }
+    m_last_log_ns = now_ns;
+    const bool log = spdlog::should_log(spdlog::level::debug);
+    std::string line;
+    const size_t zones = zone_count();
+    for (size_t i = 0; i < zones; ++i) {
+        // Advance every window even when not logging, so enabling debug shows fresh data
+        const HistogramSnapshot now = m_stages->zone(static_cast<ZoneId>(i)).snapshot();
+        const HistogramSnapshot window = now.since(m_window_start[i]);
+        m_window_start[i] = now;
+        if (!log || window.total == 0) {
+            continue;
+        }
+        line += fmt::format("{}{} {:.2f}/{:.2f}/{:.2f}", line.empty() ? "" : ", ",
+                            zone_name(static_cast<ZoneId>(i)),
+                            static_cast<double>(window.percentile(0.50)) / 1e6,
+                            static_cast<double>(window.percentile(0.99)) / 1e6,
+                            static_cast<double>(window.max) / 1e6);
+    }
+    uint64_t dropped = 0;
+    for (const auto& buffer : threads()) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    const uint64_t new_drops = dropped - m_reported_drops;
+    m_reported_drops = dropped;
+    if (!line.empty()) {
+        spdlog::debug("Stage ms (p50/p99/max): {}{}", line,
+                      new_drops ? fmt::format(" [{} events dropped]", new_drops) : std::string());
+    }
+}
+
+} // namespace instr
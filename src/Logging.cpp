@@ -0,0 +1,73 @@
+#include "Logging.hpp"
+#include <csignal>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <spdlog/async.h>
+#include <spdlog/sinks/ringbuffer_sink.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/spdlog.h>
+
+namespace {
+std::shared_ptr<spdlog::sinks::ringbuffer_sink_mt> g_ring;
+std::string g_dump_path;
+
+[[noreturn]] void on_terminate() {
+    std::fputs("Fatal: std::terminate called, dumping recent log records\n", stderr);
+    logging::dump_recent();
+    std::abort();
+}
+
+void on_fatal_signal(int sig) {
+    // Not async-signal-safe; we are about to die anyway and the ring is the most useful artifact
+    std::signal(sig, SIG_DFL);
+    logging::dump_recent();
+    std::raise(sig);
+}
+} // namespace
+
+namespace logging {
+
+void init(const Options& options) {
+    spdlog::init_thread_pool(options.queue_size, 1);
+    g_ring = std::make_shared<spdlog::sinks::ringbuffer_sink_mt>(options.ring_size);
+    g_dump_path = options.dump_path;
+
+    auto console = std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
+    spdlog::sinks_init_list sinks = {console, g_ring};
+    auto logger = std::make_shared<spdlog::async_logger>(
+        "heartbeat", sinks, spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+
+    // Keep the previous default logger's level and pattern
+    logger->set_level(spdlog::get_level());
+    logger->set_pattern("[%H:%M:%S.%e] [%^%l%$] %v");
+    spdlog::set_default_logger(logger);
+    spdlog::flush_every(std::chrono::seconds(1));
+}
+
+size_t dump_recent(size_t limit) {
+    if (!g_ring) {
+        return 0;
+    }
+    const auto records = g_ring->last_formatted(limit);
+    std::ofstream out(g_dump_path, std::ios::trunc);
+    for (const auto& line : records) {
+        out << line;
+    }
+    return records.size();
+}
+
+void install_crash_handlers() {
+    std::set_terminate(on_terminate);
+    std::signal(SIGSEGV, on_fatal_signal);
+    std::signal(SIGABRT, on_fatal_signal);
+    std::signal(SIGFPE, on_fatal_signal);
+}
+
+void shutdown() {
+    spdlog::shutdown();
+    g_ring.reset();
+}
+
+} // namespace logging
@@ -0,0 +1,164 @@
+#include "MatPool.hpp"
+#include <bit>
+#include <new>
+
+PooledMatAllocator::PooledMatAllocator(size_t max_cached_bytes) : m_max_cached(max_cached_bytes) {}
+
+PooledMatAllocator::~PooledMatAllocator() {
+    trim();
+}
+
+size_t PooledMatAllocator::size_class(size_t bytes) {
+    if (bytes <= kMinClassBytes) {
+        return kMinClassBytes;
+    }
+    // Four steps per octave: at most 25% slack, few enough classes that sizes repeat
+    const int octave = std::bit_width(bytes - 1) - 1;
+    const size_t step = size_t{1} << (octave - 2);
+    return (bytes + step - 1) / step * step;
+}
+
+cv::UMatData* PooledMatAllocator::allocate(int dims, const int* sizes, int type, void* data0, size_t* step,
+                                           cv::AccessFlag /*flags*/, cv::UMatUsageFlags /*usage_flags*/) const {
+    // Step computation mirrors OpenCV's StdMatAllocator
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; --i) {
+        if (step) {
+            if (data0 && step[i] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= static_cast<size_t>(sizes[i]);
+    }
+
+    void* block = nullptr;
+    void* header = nullptr;
+    const size_t cls = size_class(total);
+    {
+        std::lock_guard lock(m_mtx);
+        if (!m_free_headers.empty()) {
+            header = m_free_headers.back();
+            m_free_headers.pop_back();
+        }
+        if (!data0 && cls <= kMaxPooledBytes) {
+            auto it = m_free.find(cls);
+            if (it != m_free.end() && !it->second.empty()) {
+                block = it->second.back();
+                it->second.pop_back();
+                m_bytes_cached -= cls;
+            }
+        }
+    }
+    if (!data0) {
+        if (block) {
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            block = cv::fastMalloc(cls <= kMaxPooledBytes ? cls : total);
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_bytes_in_use.fetch_add(total, std::memory_order_relaxed);
+    }
+    if (!header) {
+        header = ::operator new(sizeof(cv::UMatData));
+    }
+
+    auto* u = new (header) cv::UMatData(this);
+    u->data = u->origdata = static_cast<uchar*>(data0 ? data0 : block);
+    u->size = total;
+    if (data0) {
+        u->flags |= cv::UMatData::USER_ALLOCATED;
+    }
+    return u;
+}
+
+bool PooledMatAllocator::allocate(cv::UMatData* u, cv::AccessFlag, cv::UMatUsageFlags) const {
+    return u != nullptr;
+}
+
+void PooledMatAllocator::deallocate(cv::UMatData* u) const {
+    if (!u) {
+        return;
+    }
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+    void* block = nullptr;
+    size_t cls = 0;
+    if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+        block = u->origdata;
+        cls = size_class(u->size);
+        m_bytes_in_use.fetch_sub(u->size, std::memory_order_relaxed);
+    }
+    u->origdata = nullptr;
+    u->~UMatData();
+
+    bool cached = false;
+    {
+        std::lock_guard lock(m_mtx);
+        m_free_headers.push_back(u);
+        if (block && cls <= kMaxPooledBytes && m_bytes_cached + cls <= m_max_cached) {
+            m_free[cls].push_back(block);
+            m_bytes_cached += cls;
+            cached = true;
+        }
+    }
+    if (block && !cached) {
+        cv::fastFree(block);
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PooledMatAllocator::Stats PooledMatAllocator::stats() const {
+    Stats s;
+    s.hits = m_hits.load(std::memory_order_relaxed);
+    s.misses = m_misses.load(std::memory_order_relaxed);
+    s.evictions = m_evictions.load(std::memory_order_relaxed);
+    s.bytes_in_use = m_bytes_in_use.load(std::memory_order_relaxed);
+    std::lock_guard lock(m_mtx);
+    s.bytes_cached = m_bytes_cached;
+    return s;
+}
+
+void PooledMatAllocator::trim() const {
+    std::unordered_map<size_t, std::vector<void*>> blocks;
+    std::vector<void*> headers;
+    {
+        std::lock_guard lock(m_mtx);
+        blocks.swap(m_free);
+        headers.swap(m_free_headers);
+        m_bytes_cached = 0;
+    }
+    for (auto& [cls, list] : blocks) {
+        for (void* p : list) {
+            cv::fastFree(p);
+        }
+    }
+    for (void* h : headers) {
+        ::operator delete(h);
+    }
+}
+
+namespace mat_pool {
+namespace {
+std::atomic<PooledMatAllocator*> g_installed{nullptr};
+std::mutex g_install_mtx;
+} // namespace
+
+PooledMatAllocator& install(size_t max_cached_bytes) {
+    std::lock_guard lock(g_install_mtx);
+    if (PooledMatAllocator* existing = g_installed.load()) {
+        return *existing;
+    }
+    auto* allocator = new PooledMatAllocator(max_cached_bytes); // Intentionally leaked, see header
+    cv::Mat::setDefaultAllocator(allocator);
+    g_installed.store(allocator);
+    return *allocator;
+}
+
+PooledMatAllocator* installed() {
+    return g_installed.load();
+}
+
+} // namespace mat_pool
@@ -0,0 +1,277 @@
+#include "MetricsServer.hpp"
+#include <array>
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+using socket_t = SOCKET;
+const socket_t kInvalidSocket = INVALID_SOCKET;
+
+void close_socket(socket_t s) {
+    closesocket(s);
+}
+
+int wait_readable(socket_t s, int timeout_ms) {
+    WSAPOLLFD p = {s, POLLRDNORM, 0};
+    return WSAPoll(&p, 1, timeout_ms);
+}
+
+std::string last_socket_error(const char* what) {
+    return std::string(what) + " failed (WSA error " + std::to_string(WSAGetLastError()) + ")";
+}
+#else
+using socket_t = int;
+const socket_t kInvalidSocket = -1;
+
+void close_socket(socket_t s) {
+    close(s);
+}
+
+int wait_readable(socket_t s, int timeout_ms) {
+    pollfd p = {s, POLLIN, 0};
+    return poll(&p, 1, timeout_ms);
+}
+
+std::string last_socket_error(const char* what) {
+    return std::string(what) + " failed: " + std::strerror(errno);
+}
+#endif
+
+// Latency bucket bounds exported to Prometheus, in seconds
+constexpr std::array<double, 14> kExportBounds = {
+    0.0005, 0.001, 0.002, 0.005, 0.01, 0.02, 0.033, 0.05, 0.1, 0.2, 0.5, 1.0, 2.0, 5.0};
+
+std::string metric_name(std::string_view name) {
+    std::string out = "heartbeat_";
+    for (const char c : name) {
+        const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+        out += ok ? c : '_';
+    }
+    return out;
+}
+
+std::string label_value(std::string_view v) {
+    std::string out;
+    for (const char c : v) {
+        if (c == '\\' || c == '"') {
+            out += '\\';
+            out += c;
+        } else if (c == '\n') {
+            out += "\\n";
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+#ifdef MSG_NOSIGNAL
+constexpr int kSendFlags = MSG_NOSIGNAL; // A scraper hanging up must not SIGPIPE the app
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+void send_all(socket_t s, std::string_view data) {
+    while (!data.empty()) {
+        const auto n = send(s, data.data(), static_cast<int>(data.size()), kSendFlags);
+        if (n <= 0) {
+            return;
+        }
+        data.remove_prefix(static_cast<size_t>(n));
+    }
+}
+} // namespace
+
+std::string render_prometheus(const instr::StageHistograms& stages) {
+    std::string out;
+    out.reserve(8192);
+
+    out += "# HELP heartbeat_stage_duration_seconds Duration of instrumented pipeline stages.\n";
+    out += "# TYPE heartbeat_stage_duration_seconds histogram\n";
+    const size_t zones = instr::zone_count();
+    for (size_t z = 0; z < zones; ++z) {
+        const HistogramSnapshot snap = stages.zone(static_cast<instr::ZoneId>(z)).snapshot();
+        if (snap.total == 0) {
+            continue;
+        }
+        const std::string stage = label_value(instr::zone_name(static_cast<instr::ZoneId>(z)));
+        // A bucket is counted under the first bound its upper edge fits, so counts are exact to bucket width
+        uint64_t cumulative = 0;
+        size_t i = 0;
+        for (const double bound : kExportBounds) {
+            const auto bound_ns = static_cast<uint64_t>(bound * 1e9);
+            for (; i < snap.counts.size() && latency::bucket_upper(i) <= bound_ns; ++i) {
+                cumulative += snap.counts[i];
+            }
+            out += fmt::format("heartbeat_stage_duration_seconds_bucket{{stage=\"{}\",le=\"{}\"}} {}\n",
+                               stage, bound, cumulative);
+        }
+        out += fmt::format("heartbeat_stage_duration_seconds_bucket{{stage=\"{}\",le=\"+Inf\"}} {}\n", stage, snap.total);
+        out += fmt::format("heartbeat_stage_duration_seconds_sum{{stage=\"{}\"}} {}\n", stage,
+                           static_cast<double>(snap.sum) / 1e9);
+        out += fmt::format("heartbeat_stage_duration_seconds_count{{stage=\"{}\"}} {}\n", stage, snap.total);
+    }
+
+    const size_t counters = instr::counter_count();
+    for (size_t c = 0; c < counters; ++c) {
+        const auto id = static_cast<instr::CounterId>(c);
+        const std::string name = metric_name(instr::counter_name(id)) + "_total";
+        out += fmt::format("# TYPE {} counter\n{} {}\n", name, name, instr::counter_total(id));
+    }
+
+    const size_t gauges = instr::gauge_count();
+    for (size_t g = 0; g < gauges; ++g) {
+        const auto id = static_cast<instr::GaugeId>(g);
+        const std::string name = metric_name(instr::gauge_name(id));
+        out += fmt::format("# TYPE {} gauge\n{} {}\n", name, name, instr::gauge_value(id));
+    }
+
+    uint64_t dropped = 0;
+    for (const auto& buffer : instr::threads()) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    out += fmt::format("# TYPE heartbeat_instrumentation_dropped_events_total counter\n"
+                       "heartbeat_instrumentation_dropped_events_total {}\n", dropped);
+    return out;
+}
+
+std::expected<std::unique_ptr<MetricsServer>, std::string> MetricsServer::start(
+    const Options& options, std::shared_ptr<const instr::StageHistograms> stages) {
+#ifdef _WIN32
+    static const bool wsa_ready = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    if (!wsa_ready) {
+        return std::unexpected("WSAStartup failed");
+    }
+    if (!options.unix_socket.empty()) {
+        return std::unexpected("metrics.unix_socket is not supported on Windows");
+    }
+#endif
+    socket_t s = kInvalidSocket;
+    std::string unix_path;
+#ifndef _WIN32
+    if (!options.unix_socket.empty()) {
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if (options.unix_socket.size() >= sizeof(addr.sun_path)) {
+            return std::unexpected("Unix socket path too long: " + options.unix_socket);
+        }
+        std::memcpy(addr.sun_path, options.unix_socket.c_str(), options.unix_socket.size() + 1);
+        s = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (s == kInvalidSocket) {
+            return std::unexpected(last_socket_error("socket"));
+        }
+        unlink(options.unix_socket.c_str()); // Stale socket from a previous run
+        if (bind(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+            auto err = last_socket_error("bind");
+            close_socket(s);
+            return std::unexpected(err);
+        }
+        unix_path = options.unix_socket;
+    }
+#endif
+    if (s == kInvalidSocket) {
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(options.port);
+        if (inet_pton(AF_INET, options.bind_address.c_str(), &addr.sin_addr) != 1) {
+            return std::unexpected("Invalid metrics bind address: " + options.bind_address);
+        }
+        s = socket(AF_INET, SOCK_STREAM, 0);
+        if (s == kInvalidSocket) {
+            return std::unexpected(last_socket_error("socket"));
+        }
+        const int yes = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&yes), sizeof(yes));
+        if (bind(s, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+            auto err = last_socket_error("bind");
+            close_socket(s);
+            return std::unexpected(err);
+        }
+    }
+    if (listen(s, 8) != 0) {
+        auto err = last_socket_error("listen");
+        close_socket(s);
+        return std::unexpected(err);
+    }
+    return std::unique_ptr<MetricsServer>(
+        new MetricsServer(static_cast<std::intptr_t>(s), std::move(unix_path), std::move(stages)));
+}
+
+MetricsServer::MetricsServer(std::intptr_t listen_socket, std::string unix_path,
+                             std::shared_ptr<const instr::StageHistograms> stages)
+    : m_listen(listen_socket), m_unix_path(std::move(unix_path)), m_stages(std::move(stages)) {
+    m_worker = std::jthread([this](std::stop_token st) { serve(st); });
+}
+
+MetricsServer::~MetricsServer() {
+    m_worker.request_stop();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+    close_socket(static_cast<socket_t>(m_listen));
+#ifndef _WIN32
+    if (!m_unix_path.empty()) {
+        unlink(m_unix_path.c_str());
+    }
+#endif
+}
+
+void MetricsServer::serve(std::stop_token st) {
+    HBM_THREAD_NAME("metrics");
+    const auto listen_socket = static_cast<socket_t>(m_listen);
+    while (!st.stop_requested()) {
+        // Short poll so shutdown never waits on a scrape that is not coming
+        if (wait_readable(listen_socket, 200) <= 0) {
+            continue;
+        }
+        const socket_t client = accept(listen_socket, nullptr, nullptr);
+        if (client == kInvalidSocket) {
+            continue;
+        }
+        handle(static_cast<std::intptr_t>(client));
+        close_socket(client);
+    }
+}
+
+void MetricsServer::handle(std::intptr_t client_handle) {
+    const auto client = static_cast<socket_t>(client_handle);
+    std::string request;
+    std::array<char, 1024> buf;
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        if (wait_readable(client, 1000) <= 0) {
+            return;
+        }
+        const auto n = recv(client, buf.data(), static_cast<int>(buf.size()), 0);
+        if (n <= 0) {
+            return;
+        }
+        request.append(buf.data(), static_cast<size_t>(n));
+    }
+
+    const bool is_metrics = request.starts_with("GET /metrics ") || request.starts_with("GET /metrics?");
+    const std::string body = is_metrics ? render_prometheus(*m_stages) : "Not found; try /metrics\n";
+    const std::string header = fmt::format(
+        "HTTP/1.0 {}\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        "Content-Length: {}\r\nConnection: close\r\n\r\n",
+        is_metrics ? "200 OK" : "404 Not Found", body.size());
+    send_all(client, header);
+    send_all(client, body);
+}
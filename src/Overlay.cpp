@@ -4,6 +4,7 @@
  */
 
 #include "Overlay.hpp"
+#include "Instrumentation.hpp"
 #include <stdexcept>
 #include <print>
 #include <format>
@@ -11,12 +12,60 @@
 #include <sstream>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 
-struct GDIObjectDeleter {
-    void operator()(HGDIOBJ obj) const { if (obj) DeleteObject(obj); }
-};
-using UniqueGDIObject = std::unique_ptr<std::remove_pointer_t<HGDIOBJ>, GDIObjectDeleter>;
+namespace {
+/**
+ * @brief Allocates a top-down 32-bit DIB section and returns its pixel pointer.
+ */
+UniqueGDIObject create_bgra_dib(int w, int h, void** bits) {
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = w;
+    bmi.bmiHeader.biHeight = -h; // Negative for top-down orientation
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    UniqueGDIObject dib(CreateDIBSection(NULL, &bmi, DIB_RGB_COLORS, bits, NULL, 0));
+    if (!dib || !*bits) {
+        throw std::runtime_error("Failed to create HUD DIB section.");
+    }
+    return dib;
+}
 
+/**
+ * @brief Rasterizes the HUD charset with the configured GDI font into a glyph atlas.
+ */
+GlyphAtlas rasterize_gdi(HFONT font) {
+    UniqueDC dc(CreateCompatibleDC(NULL));
+    HGDIOBJ old_font = SelectObject(dc.get(), font);
+    SetBkMode(dc.get(), TRANSPARENT);
+    SetTextColor(dc.get(), RGB(255, 255, 255));
+    TEXTMETRICA tm = {};
+    GetTextMetricsA(dc.get(), &tm);
+    const int h = std::max<int>(1, tm.tmHeight);
+
+    std::vector<std::pair<char, cv::Mat>> cells;
+    for (char ch : GlyphAtlas::kHudCharset) {
+        SIZE sz = {};
+        GetTextExtentPoint32A(dc.get(), &ch, 1, &sz);
+        const int w = std::max<int>(1, sz.cx);
+        void* bits = nullptr;
+        UniqueGDIObject dib = create_bgra_dib(w, h, &bits);
+        HGDIOBJ old_bmp = SelectObject(dc.get(), dib.get());
+        PatBlt(dc.get(), 0, 0, w, h, BLACKNESS);
+        TextOutA(dc.get(), 0, 0, &ch, 1);
+        GdiFlush();
+        // White on black: any channel is the coverage
+        cv::Mat coverage;
+        cv::extractChannel(cv::Mat(h, w, CV_8UC4, bits), coverage, 1);
+        cells.emplace_back(ch, std::move(coverage));
+        SelectObject(dc.get(), old_bmp);
+    }
+    SelectObject(dc.get(), old_font);
+    return GlyphAtlas::pack(cells);
+}
+} // namespace
 
 /**
  * @brief Constructor for the HUD Overlay.
@@ -52,6 +101,28 @@ Overlay::Overlay(const AppConfig& c)
     }
     m_window_w = m_cfg.hud.width;
     m_window_h = m_cfg.hud.height;
+    for (auto& tenths : m_shown_bpm_tenths) {
+        tenths.store(-1, std::memory_order_relaxed);
+    }
+
+    // Frame surfaces are sized for the largest HUD so the producer never reallocates them
+    m_frames.for_each([&](Surface& s) {
+        void* bits = nullptr;
+        s.dib = create_bgra_dib(m_cfg.hud.width, m_cfg.hud.height, &bits);
+        s.pixels = cv::Mat(m_cfg.hud.height, m_cfg.hud.width, CV_8UC4, bits);
+        s.pixels.setTo(cv::Scalar::all(0));
+    });
+    rebuild_gdi_resources(m_window_w, m_window_h);
+
+    // Coalesce repaints to the monitor refresh rate
+    if (HDC screen = GetDC(NULL)) {
+        const int hz = GetDeviceCaps(screen, VREFRESH);
+        if (hz > 1) {
+            m_refresh_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / hz));
+        }
+        ReleaseDC(NULL, screen);
+    }
 
     // Configure transparency: Black pixels are invisible, global alpha controls opacity
     SetLayeredWindowAttributes(m_hwnd, RGB(0, 0, 0), m_cfg.hud.alpha, LWA_COLORKEY | LWA_ALPHA);
@@ -66,6 +137,22 @@ Overlay::Overlay(const AppConfig& c)
                      m_cfg.hud.hotkey_toggle_debug);
     }
 
+    // Optional second hotkey: dump the in-memory log ring
+    if (!m_cfg.hud.hotkey_dump_log.empty()) {
+        parse_hotkey(m_cfg.hud.hotkey_dump_log, modifiers, vk);
+        if (vk == 0 || !RegisterHotKey(m_hwnd, HOTKEY_DUMP_LOG_ID, modifiers, vk)) {
+            std::println(stderr, "Hotkey Error: '{}' is invalid or already in use.",
+                         m_cfg.hud.hotkey_dump_log);
+        }
+    }
+    if (!m_cfg.hud.hotkey_dump_trace.empty()) {
+        parse_hotkey(m_cfg.hud.hotkey_dump_trace, modifiers, vk);
+        if (vk == 0 || !RegisterHotKey(m_hwnd, HOTKEY_DUMP_TRACE_ID, modifiers, vk)) {
+            std::println(stderr, "Hotkey Error: '{}' is invalid or already in use.",
+                         m_cfg.hud.hotkey_dump_trace);
+        }
+    }
+
     ShowWindow(m_hwnd, SW_SHOW);
 }
 
@@ -75,41 +162,186 @@ Overlay::Overlay(const AppConfig& c)
 Overlay::~Overlay() {
     stop();
     UnregisterHotKey(m_hwnd, HOTKEY_ID);
+    UnregisterHotKey(m_hwnd, HOTKEY_DUMP_LOG_ID);
+    UnregisterHotKey(m_hwnd, HOTKEY_DUMP_TRACE_ID);
     if (m_hwnd) DestroyWindow(m_hwnd);
+    if (m_back_dc) {
+        SelectObject(m_back_dc.get(), m_back_dc_default);
+    }
 }
 
-void Overlay::update_bpm(double bpm) {
-    m_bpm = bpm;
-    // Request a repaint on the UI thread
-    if (m_hwnd) InvalidateRect(m_hwnd, NULL, FALSE);
+Overlay::PaintStats Overlay::paint_stats() const {
+    PaintStats stats;
+    stats.requested = m_repaint_requests.load(std::memory_order_relaxed);
+    stats.paints = m_paint_count.load(std::memory_order_relaxed);
+    if (stats.paints > 0) {
+        stats.avg_paint_us = m_paint_ns.load(std::memory_order_relaxed) / 1000.0 / stats.paints;
+    }
+    return stats;
+}
+
+void Overlay::rebuild_gdi_resources(int w, int h) {
+    w = std::max(1, w);
+    h = std::max(1, h);
+    if (!m_font) {
+        m_font.reset(CreateFontA(
+            m_cfg.hud.font_size, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE,
+            DEFAULT_CHARSET, OUT_OUTLINE_PRECIS, CLIP_DEFAULT_PRECIS,
+            CLEARTYPE_QUALITY, VARIABLE_PITCH,
+            m_cfg.hud.font_name.c_str()
+        ));
+    }
+    if (!m_compositor) {
+        m_compositor = std::make_unique<HudCompositor>(
+            rasterize_gdi(static_cast<HFONT>(m_font.get())),
+            cv::Scalar(m_cfg.hud.b, m_cfg.hud.g, m_cfg.hud.r));
+        // Text area: widest string we draw, shadow included
+        const cv::Size bpm = m_compositor->measure("BPM: 888.8");
+        const cv::Size analyzing = m_compositor->measure("Analyzing...");
+        std::string camera_lines; // One "name: BPM" line per camera when there are several
+        if (m_cfg.cameras.size() > 1) {
+            for (size_t i = 0; i < m_cfg.cameras.size(); ++i) {
+                camera_lines += std::format("{}{}: 888.8", i ? "\n" : "", m_cfg.cameras[i].name);
+            }
+        }
+        const cv::Size cameras = m_compositor->measure(camera_lines);
+        m_text_rect = {0, 0, std::max({bpm.width, analyzing.width, cameras.width}),
+                       std::max({bpm.height, analyzing.height, cameras.height})};
+        if (m_cfg.hud.sparkline_height > 0) {
+            m_sparkline = std::make_unique<BpmSparkline>(
+                cv::Size(m_cfg.hud.width, m_cfg.hud.sparkline_height),
+                cv::Scalar(m_cfg.hud.b, m_cfg.hud.g, m_cfg.hud.r),
+                m_cfg.analysis.min_bpm, m_cfg.analysis.max_bpm);
+        }
+    }
+    if (!m_back_dc) {
+        m_back_dc.reset(CreateCompatibleDC(NULL));
+    }
+    if (m_back_dib && w == m_back_w && h == m_back_h) {
+        return;
+    }
+
+    void* bits = nullptr;
+    UniqueGDIObject dib = create_bgra_dib(w, h, &bits);
+    HGDIOBJ prev = SelectObject(m_back_dc.get(), dib.get());
+    if (!m_back_dib) {
+        m_back_dc_default = prev;
+    }
+    m_back_dib = std::move(dib);
+    m_back_pixels = cv::Mat(h, w, CV_8UC4, bits);
+    m_back_w = w;
+    m_back_h = h;
+    // Sparkline strip hugs the bottom edge
+    const int spark_h = m_sparkline ? m_sparkline->image().rows : 0;
+    m_sparkline_rect = {0, std::max(0, h - spark_h), w, h};
+}
+
+void Overlay::update_bpm(double bpm, size_t camera) {
+    if (camera >= m_bpm.size()) {
+        return;
+    }
+    m_bpm[camera] = bpm;
+    // The HUD shows one decimal; skip repaints that would draw the same text
+    const int tenths = static_cast<int>(std::lround(bpm * 10.0));
+    uint32_t dirty = 0;
+    if (m_shown_bpm_tenths[camera].exchange(tenths, std::memory_order_relaxed) != tenths) {
+        dirty |= kDirtyText;
+    }
+    // Every estimate scrolls the sparkline, even if the number is unchanged (primary camera only)
+    if (camera == 0 && m_cfg.hud.sparkline_height > 0 && m_bpm_history.try_push(bpm)) {
+        dirty |= kDirtySparkline;
+    }
+    if (dirty) {
+        request_repaint(dirty);
+    }
+}
+
+std::string Overlay::bpm_text() const {
+    if (m_cfg.cameras.size() <= 1) {
+        const double bpm = m_bpm[0].load();
+        return bpm > 0 ? std::format("BPM: {:.1f}", bpm) : "Analyzing...";
+    }
+    std::string text;
+    for (size_t i = 0; i < m_cfg.cameras.size() && i < m_bpm.size(); ++i) {
+        const double bpm = m_bpm[i].load();
+        text += std::format("{}{}: {}", i ? "\n" : "", m_cfg.cameras[i].name,
+                            bpm > 0 ? std::format("{:.1f}", bpm) : "...");
+    }
+    return text;
+}
+
+void Overlay::request_repaint(uint32_t dirty_bits) {
+    m_repaint_requests.fetch_add(1, std::memory_order_relaxed);
+    // Only the first dirty bit since the last flush wakes the UI thread
+    if (m_dirty.fetch_or(dirty_bits, std::memory_order_acq_rel) == 0 && m_hwnd) {
+        PostMessage(m_hwnd, WM_APP_REPAINT, 0, 0);
+    }
+}
+
+void Overlay::flush_repaint() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto since_last = now - m_last_invalidate;
+    if (since_last < m_refresh_interval) {
+        if (!m_repaint_timer_armed) {
+            const auto wait = std::chrono::ceil<std::chrono::milliseconds>(m_refresh_interval - since_last);
+            SetTimer(m_hwnd, REPAINT_TIMER_ID, static_cast<UINT>(std::max<long long>(1, wait.count())), NULL);
+            m_repaint_timer_armed = true;
+        }
+        return;
+    }
+    const uint32_t dirty = m_dirty.exchange(0, std::memory_order_acq_rel);
+    if (dirty & kDirtyFrame) {
+        InvalidateRect(m_hwnd, NULL, FALSE);
+    } else {
+        if (dirty & kDirtyText) {
+            InvalidateRect(m_hwnd, &m_text_rect, FALSE);
+        }
+        if (dirty & kDirtySparkline) {
+            InvalidateRect(m_hwnd, &m_sparkline_rect, FALSE);
+        }
+    }
+    if (dirty) {
+        m_last_invalidate = now;
+    }
 }
 
 void Overlay::update_frame(const cv::Mat& frame) {
     if (frame.empty()) {
         return;
     }
-    {
-        std::lock_guard<std::mutex> lock(m_mtx);
-        // Copy the frame to our internal buffer for the UI thread to use
-        frame.copyTo(m_frame);
-        m_frame_w = frame.cols;
-        m_frame_h = frame.rows;
-    }
-    if (m_hwnd && m_frame_w > 0 && m_frame_h > 0) {
-        const int max_w = m_cfg.hud.width;
-        const int max_h = m_cfg.hud.height;
-        const double scale = std::min(static_cast<double>(max_w) / m_frame_w,
-                                      static_cast<double>(max_h) / m_frame_h);
-        const int new_w = std::max(1, static_cast<int>(std::lround(m_frame_w * scale)));
-        const int new_h = std::max(1, static_cast<int>(std::lround(m_frame_h * scale)));
-        if (new_w != m_window_w || new_h != m_window_h) {
-            m_window_w = new_w;
-            m_window_h = new_h;
-            SetWindowPos(m_hwnd, NULL, 0, 0, m_window_w, m_window_h,
-                         SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+    m_frame_w = frame.cols;
+    m_frame_h = frame.rows;
+
+    // Writes straight into the DIB bits of the back surface
+    Surface& surface = m_frames.back();
+    surface.size = hud::fit_frame_bgra(frame, cv::Size(m_cfg.hud.width, m_cfg.hud.height), m_scaled, surface.pixels);
+    m_frames.publish();
+    const int new_w = surface.size.width;
+    const int new_h = surface.size.height;
+
+    if (m_hwnd && (new_w != m_window_w || new_h != m_window_h)) {
+        m_window_w = new_w;
+        m_window_h = new_h;
+        SetWindowPos(m_hwnd, NULL, 0, 0, m_window_w, m_window_h,
+                     SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+    }
+    request_repaint(kDirtyFrame);
+}
+
+void Overlay::update_debug_layer(const cv::Mat& layer) {
+    if (layer.empty()) {
+        if (m_debug_layer_visible) {
+            m_debug_layers.back().release();
+            m_debug_layers.publish();
+            m_debug_layer_visible = false;
+            request_repaint(kDirtyFrame);
         }
+        return;
     }
-    if (m_hwnd) InvalidateRect(m_hwnd, NULL, FALSE);
+    layer.copyTo(m_debug_layers.back());
+    m_debug_layers.publish();
+    m_debug_layer_visible = true;
+    request_repaint(kDirtyFrame);
 }
 
 void Overlay::stop() {
@@ -118,6 +350,7 @@ void Overlay::stop() {
 }
 
 void Overlay::run() {
+    HBM_THREAD_NAME("hud");
     MSG msg = {};
     while (m_running && GetMessage(&msg, NULL, 0, 0)) {
         TranslateMessage(&msg);
@@ -174,62 +407,53 @@ void Overlay::parse_hotkey(const std::string& str, UINT& out_mod, UINT& out_vk)
 }
 
 /**
- * @brief Draws the OpenCV frame and BPM text using GDI.
+ * @brief Composes the latest frame, debug layer and BPM text into the back buffer and blits it.
+ * @param dirty Update region from BeginPaint; a text-only repaint keeps the current frame.
  */
-void Overlay::paint(HDC hdc) {
+void Overlay::paint(HDC hdc, const RECT& dirty) {
+    HBM_ZONE("paint");
+    const auto paint_start = std::chrono::steady_clock::now();
     RECT rect;
     GetClientRect(m_hwnd, &rect);
     int hud_w = rect.right - rect.left;
     int hud_h = rect.bottom - rect.top;
+    rebuild_gdi_resources(hud_w, hud_h);
 
-    // 1. Render the Camera Frame (if available)
-    {
-        std::lock_guard<std::mutex> lock(m_mtx);
-        if (!m_frame.empty()) {
-            // GDI works best with 32-bit BGRA
-            cv::Mat bgra;
-            cv::cvtColor(m_frame, bgra, cv::COLOR_BGR2BGRA);
-
-            BITMAPINFO bmi = {};
-            bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-            bmi.bmiHeader.biWidth = bgra.cols;
-            bmi.bmiHeader.biHeight = -bgra.rows; // Negative for top-down orientation
-            bmi.bmiHeader.biPlanes = 1;
-            bmi.bmiHeader.biBitCount = 32;
-            bmi.bmiHeader.biCompression = BI_RGB;
-
-            SetStretchBltMode(hdc, COLORONCOLOR);
-            StretchDIBits(hdc, 
-                0, 0, hud_w, hud_h,           // Destination (Scaled)
-                0, 0, bgra.cols, bgra.rows,    // Source
-                bgra.data, &bmi, DIB_RGB_COLORS, SRCCOPY);
+    const bool full_repaint = dirty.left <= 0 && dirty.top <= 0 &&
+                              dirty.right >= hud_w && dirty.bottom >= hud_h;
+    if (full_repaint) {
+        m_frames.acquire();
+        m_debug_layers.acquire();
+    }
+    const Surface& surface = m_frames.front();
+    const cv::Mat frame = surface.size.empty()
+        ? cv::Mat()
+        : surface.pixels(cv::Rect(cv::Point(0, 0), surface.size));
+    // Scroll the sparkline by however many estimates arrived since the last paint
+    static const cv::Mat kNoLayer;
+    double history_bpm = 0.0;
+    while (m_bpm_history.try_pop(history_bpm)) {
+        if (m_sparkline) {
+            m_sparkline->push(history_bpm);
         }
     }
+    const HudLayer layers[] = {
+        {&m_debug_layers.front(), cv::Point(0, 0)},
+        // Right-aligned so the newest column stays visible if the window is narrower
+        {m_sparkline ? &m_sparkline->image() : &kNoLayer,
+         cv::Point(m_sparkline ? m_back_w - m_sparkline->image().cols : 0, m_sparkline_rect.top)},
+    };
 
-    // 2. Render Text Overlay
-    UniqueGDIObject hFont(CreateFontA(
-        m_cfg.hud.font_size, 0, 0, 0, FW_BOLD, FALSE, FALSE, FALSE, 
-        DEFAULT_CHARSET, OUT_OUTLINE_PRECIS, CLIP_DEFAULT_PRECIS, 
-        CLEARTYPE_QUALITY, VARIABLE_PITCH, 
-        m_cfg.hud.font_name.c_str()
-    ));
-    
-    HGDIOBJ hOldFont = SelectObject(hdc, hFont.get());
-    SetBkMode(hdc, TRANSPARENT);
+    m_compositor->compose(m_back_pixels, frame, layers, bpm_text());
 
-    std::string text = m_bpm > 0 
-        ? std::format("BPM: {:.1f}", m_bpm.load()) 
-        : "Analyzing...";
+    BitBlt(hdc, dirty.left, dirty.top, dirty.right - dirty.left, dirty.bottom - dirty.top,
+           m_back_dc.get(), dirty.left, dirty.top, SRCCOPY);
+    // Flush the batched blit before the compositor writes the back buffer again
+    GdiFlush();
 
-    // Draw shadow for readability
-    SetTextColor(hdc, RGB(0, 0, 0));
-    TextOutA(hdc, 2, 2, text.c_str(), (int)text.length());
-    
-    // Draw foreground
-    SetTextColor(hdc, RGB(m_cfg.hud.r, m_cfg.hud.g, m_cfg.hud.b));
-    TextOutA(hdc, 0, 0, text.c_str(), (int)text.length());
-
-    SelectObject(hdc, hOldFont);
+    m_paint_ns.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - paint_start).count()), std::memory_order_relaxed);
+    m_paint_count.fetch_add(1, std::memory_order_relaxed);
 }
 
 /**
@@ -250,13 +474,33 @@ LRESULT CALLBACK Overlay::WindowProc(HWND h, UINT m, WPARAM w, LPARAM l) {
             case WM_HOTKEY:
                 if (w == pOverlay->HOTKEY_ID) {
                     pOverlay->m_debug_enabled = !pOverlay->m_debug_enabled;
+                } else if (w == pOverlay->HOTKEY_DUMP_LOG_ID && pOverlay->m_on_dump_log) {
+                    pOverlay->m_on_dump_log();
+                } else if (w == pOverlay->HOTKEY_DUMP_TRACE_ID && pOverlay->m_on_dump_trace) {
+                    pOverlay->m_on_dump_trace();
+                }
+                return 0;
+
+            case WM_APP_REPAINT:
+                pOverlay->flush_repaint();
+                return 0;
+
+            case WM_TIMER:
+                if (w == REPAINT_TIMER_ID) {
+                    KillTimer(h, REPAINT_TIMER_ID);
+                    pOverlay->m_repaint_timer_armed = false;
+                    pOverlay->flush_repaint();
                 }
                 return 0;
 
+            case WM_SIZE:
+                pOverlay->rebuild_gdi_resources(LOWORD(l), HIWORD(l));
+                return 0;
+
             case WM_PAINT: {
                 PAINTSTRUCT ps;
                 HDC hdc = BeginPaint(h, &ps);
-                pOverlay->paint(hdc);
+                pOverlay->paint(hdc, ps.rcPaint);
                 EndPaint(h, &ps);
                 return 0;
             }
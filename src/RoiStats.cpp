@@ -0,0 +1,207 @@
+#include "RoiStats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string_view>
+
+#if HBM_SIMD_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace roi_stats {
+
+namespace {
+
+#if HBM_SIMD_X86
+struct CpuFeatures {
+    bool sse42 = false;
+    bool avx2 = false;
+    bool avx512bw = false;
+};
+
+void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<unsigned>(r[i]);
+    }
+#else
+    if (!__get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3])) {
+        regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    }
+#endif
+}
+
+uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+}
+
+CpuFeatures detect() {
+    CpuFeatures f;
+    unsigned r1[4] = {};
+    unsigned r7[4] = {};
+    cpuid(0, 0, r1);
+    const unsigned max_leaf = r1[0];
+    cpuid(1, 0, r1);
+    if (max_leaf >= 7) {
+        cpuid(7, 0, r7);
+    }
+    const unsigned ecx1 = r1[2];
+    const unsigned ebx7 = r7[1];
+
+    const bool ssse3 = ecx1 & (1u << 9);
+    const bool sse41 = ecx1 & (1u << 19);
+    const bool popcnt = ecx1 & (1u << 23);
+    f.sse42 = ssse3 && sse41 && (ecx1 & (1u << 20)) && popcnt;
+
+    // Wide registers also need the OS to save their state across context switches
+    const bool osxsave = ecx1 & (1u << 27);
+    const uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+    const bool os_ymm = (xcr0 & 0x6) == 0x6;
+    const bool os_zmm = (xcr0 & 0xE6) == 0xE6;
+    f.avx2 = f.sse42 && os_ymm && (ecx1 & (1u << 28)) && (ebx7 & (1u << 5));
+    f.avx512bw = f.avx2 && os_zmm && (ebx7 & (1u << 16)) && (ebx7 & (1u << 30));
+    return f;
+}
+
+const CpuFeatures& features() {
+    static const CpuFeatures f = detect();
+    return f;
+}
+#endif
+
+bool supported(Isa isa) {
+    switch (isa) {
+    case Isa::Scalar:
+        return true;
+#if HBM_SIMD_X86
+    case Isa::Sse42:
+        return features().sse42;
+    case Isa::Avx2:
+        return features().avx2;
+    case Isa::Avx512:
+        return features().avx512bw;
+#endif
+#if HBM_SIMD_NEON
+    case Isa::Neon:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+Isa detect_active() {
+    // Highest first; HBM_SIMD names the ceiling
+    constexpr Isa kPreference[] = {Isa::Avx512, Isa::Avx2, Isa::Sse42, Isa::Neon, Isa::Scalar};
+    const char* env = std::getenv("HBM_SIMD");
+    bool below_cap = env == nullptr;
+    for (Isa isa : kPreference) {
+        below_cap = below_cap || std::string_view(env) == isa_name(isa);
+        if (below_cap && supported(isa)) {
+            return isa;
+        }
+    }
+    return Isa::Scalar;
+}
+
+} // namespace
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+    case Isa::Scalar:
+        return "scalar";
+    case Isa::Sse42:
+        return "sse42";
+    case Isa::Avx2:
+        return "avx2";
+    case Isa::Avx512:
+        return "avx512";
+    case Isa::Neon:
+        return "neon";
+    }
+    return "unknown";
+}
+
+Isa active_isa() {
+    static const Isa isa = detect_active();
+    return isa;
+}
+
+RowKernel kernel(Isa isa) {
+    if (!supported(isa)) {
+        return nullptr;
+    }
+    switch (isa) {
+    case Isa::Scalar:
+        return detail::accumulate_scalar;
+#if HBM_SIMD_X86
+    case Isa::Sse42:
+        return detail::accumulate_sse42;
+    case Isa::Avx2:
+        return detail::accumulate_avx2;
+    case Isa::Avx512:
+        return detail::accumulate_avx512;
+#endif
+#if HBM_SIMD_NEON
+    case Isa::Neon:
+        return detail::accumulate_neon;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+Accum compute(const cv::Mat& bgr, const cv::Mat& mask, const Options& options) {
+    static const RowKernel k = kernel(active_isa());
+
+    Accum acc;
+    if (bgr.empty()) {
+        return acc;
+    }
+    CV_Assert(bgr.type() == CV_8UC3);
+    CV_Assert(mask.empty() || (mask.type() == CV_8UC1 && mask.size() == bgr.size()));
+
+    const bool has_mask = !mask.empty();
+    if (bgr.isContinuous() && (!has_mask || mask.isContinuous())) {
+        k(bgr.ptr<uint8_t>(), has_mask ? mask.ptr<uint8_t>() : nullptr, bgr.total(), options.clip_lo,
+          options.clip_hi, acc);
+        return acc;
+    }
+    for (int y = 0; y < bgr.rows; ++y) {
+        k(bgr.ptr<uint8_t>(y), has_mask ? mask.ptr<uint8_t>(y) : nullptr, static_cast<size_t>(bgr.cols),
+          options.clip_lo, options.clip_hi, acc);
+    }
+    return acc;
+}
+
+cv::Scalar mean(const Accum& acc) {
+    // Same expression as cv::mean: exact integer sums scaled by 1/count
+    const double scale = acc.count ? 1.0 / static_cast<double>(acc.count) : 0.0;
+    return cv::Scalar(static_cast<double>(acc.sum[0]) * scale, static_cast<double>(acc.sum[1]) * scale,
+                      static_cast<double>(acc.sum[2]) * scale, 0.0);
+}
+
+cv::Scalar stddev(const Accum& acc) {
+    const cv::Scalar m = mean(acc);
+    const double scale = acc.count ? 1.0 / static_cast<double>(acc.count) : 0.0;
+    cv::Scalar sd;
+    for (int c = 0; c < 3; ++c) {
+        sd[c] = std::sqrt(std::max(0.0, static_cast<double>(acc.sum_sq[c]) * scale - m[c] * m[c]));
+    }
+    return sd;
+}
+
+} // namespace roi_stats
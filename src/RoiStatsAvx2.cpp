@@ -0,0 +1,97 @@
+// Compiled with -mavx2 -mpopcnt; only reached after CPUID/XGETBV confirm support.
+#include "RoiKernels.hpp"
+#include <immintrin.h>
+
+namespace roi_stats::detail {
+
+namespace {
+
+// Lane k of the result holds bytes 16s..16s+15 of the k-th 48-byte run, so the per-lane pshufb
+// deinterleaves pixels 0-15 into lane 0 and 16-31 into lane 1, matching a contiguous mask load.
+inline __m256i load_runs(const uint8_t* bgr, int s) {
+    const __m128i lane0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + 16 * s));
+    const __m128i lane1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + 48 + 16 * s));
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(lane0), lane1, 1);
+}
+
+inline __m256i widen_add(__m256i acc64, __m256i v32) {
+    const __m256i zero = _mm256_setzero_si256();
+    return _mm256_add_epi64(acc64, _mm256_add_epi64(_mm256_unpacklo_epi32(v32, zero), _mm256_unpackhi_epi32(v32, zero)));
+}
+
+inline uint64_t hsum64(__m256i v) {
+    const __m128i s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(s)) + static_cast<uint64_t>(_mm_extract_epi64(s, 1));
+}
+
+} // namespace
+
+void accumulate_avx2(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi,
+                     Accum& acc) {
+    __m256i shuf[3][3];
+    for (int c = 0; c < 3; ++c) {
+        for (int s = 0; s < 3; ++s) {
+            shuf[c][s] = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(kDeinterleave[c][s])));
+        }
+    }
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi8(-1);
+    const __m256i lo = _mm256_set1_epi8(static_cast<char>(clip_lo));
+    const __m256i hi = _mm256_set1_epi8(static_cast<char>(clip_hi));
+
+    __m256i sum[3] = {zero, zero, zero};
+    __m256i sq64[3] = {zero, zero, zero};
+    __m256i sq32[3] = {zero, zero, zero};
+    uint64_t clipped = 0;
+    uint64_t count = 0;
+
+    size_t i = 0;
+    size_t blocks = 0;
+    for (; i + 32 <= n; i += 32, bgr += 96) {
+        const __m256i a0 = load_runs(bgr, 0);
+        const __m256i a1 = load_runs(bgr, 1);
+        const __m256i a2 = load_runs(bgr, 2);
+        const __m256i sel =
+            mask ? _mm256_xor_si256(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i)), zero), ones)
+                 : ones;
+
+        __m256i clip = zero;
+        for (int c = 0; c < 3; ++c) {
+            __m256i v = _mm256_or_si256(
+                _mm256_or_si256(_mm256_shuffle_epi8(a0, shuf[c][0]), _mm256_shuffle_epi8(a1, shuf[c][1])),
+                _mm256_shuffle_epi8(a2, shuf[c][2]));
+            clip = _mm256_or_si256(clip, _mm256_cmpeq_epi8(_mm256_min_epu8(v, lo), v)); // v <= lo
+            clip = _mm256_or_si256(clip, _mm256_cmpeq_epi8(_mm256_max_epu8(v, hi), v)); // v >= hi
+            v = _mm256_and_si256(v, sel);
+            sum[c] = _mm256_add_epi64(sum[c], _mm256_sad_epu8(v, zero));
+            const __m256i v_lo = _mm256_unpacklo_epi8(v, zero);
+            const __m256i v_hi = _mm256_unpackhi_epi8(v, zero);
+            sq32[c] = _mm256_add_epi32(sq32[c],
+                                       _mm256_add_epi32(_mm256_madd_epi16(v_lo, v_lo), _mm256_madd_epi16(v_hi, v_hi)));
+        }
+        clipped += static_cast<uint64_t>(
+            _mm_popcnt_u32(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(clip, sel)))));
+        count += static_cast<uint64_t>(_mm_popcnt_u32(static_cast<uint32_t>(_mm256_movemask_epi8(sel))));
+
+        if (++blocks == kSquareFlushBlocks) {
+            blocks = 0;
+            for (int c = 0; c < 3; ++c) {
+                sq64[c] = widen_add(sq64[c], sq32[c]);
+                sq32[c] = zero;
+            }
+        }
+    }
+
+    for (int c = 0; c < 3; ++c) {
+        acc.sum[c] += hsum64(sum[c]);
+        acc.sum_sq[c] += hsum64(widen_add(sq64[c], sq32[c]));
+    }
+    acc.clipped += clipped;
+    acc.count += count;
+
+    if (i < n) {
+        accumulate_scalar(bgr, mask ? mask + i : nullptr, n - i, clip_lo, clip_hi, acc);
+    }
+}
+
+} // namespace roi_stats::detail
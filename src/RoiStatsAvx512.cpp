@@ -0,0 +1,95 @@
+// Compiled with -mavx512f -mavx512bw -mpopcnt; only reached after CPUID/XGETBV confirm support.
+#include "RoiKernels.hpp"
+#include <immintrin.h>
+
+namespace roi_stats::detail {
+
+namespace {
+
+// Lane k holds bytes 16s..16s+15 of the k-th 48-byte run (see RoiStatsAvx2.cpp)
+inline __m512i load_runs(const uint8_t* bgr, int s) {
+    __m512i v = _mm512_castsi128_si512(_mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + 16 * s)));
+    v = _mm512_inserti32x4(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + 48 + 16 * s)), 1);
+    v = _mm512_inserti32x4(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + 96 + 16 * s)), 2);
+    return _mm512_inserti32x4(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + 144 + 16 * s)), 3);
+}
+
+inline __m512i widen_add(__m512i acc64, __m512i v32) {
+    const __m512i zero = _mm512_setzero_si512();
+    return _mm512_add_epi64(acc64, _mm512_add_epi64(_mm512_unpacklo_epi32(v32, zero), _mm512_unpackhi_epi32(v32, zero)));
+}
+
+inline uint64_t hsum64(__m512i v) {
+    return static_cast<uint64_t>(_mm512_reduce_add_epi64(v));
+}
+
+} // namespace
+
+void accumulate_avx512(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi,
+                       Accum& acc) {
+    __m512i shuf[3][3];
+    for (int c = 0; c < 3; ++c) {
+        for (int s = 0; s < 3; ++s) {
+            shuf[c][s] = _mm512_broadcast_i32x4(_mm_load_si128(reinterpret_cast<const __m128i*>(kDeinterleave[c][s])));
+        }
+    }
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i lo = _mm512_set1_epi8(static_cast<char>(clip_lo));
+    const __m512i hi = _mm512_set1_epi8(static_cast<char>(clip_hi));
+
+    __m512i sum[3] = {zero, zero, zero};
+    __m512i sq64[3] = {zero, zero, zero};
+    __m512i sq32[3] = {zero, zero, zero};
+    uint64_t clipped = 0;
+    uint64_t count = 0;
+
+    size_t i = 0;
+    size_t blocks = 0;
+    for (; i + 64 <= n; i += 64, bgr += 192) {
+        const __m512i a0 = load_runs(bgr, 0);
+        const __m512i a1 = load_runs(bgr, 1);
+        const __m512i a2 = load_runs(bgr, 2);
+        __mmask64 sel = ~__mmask64{0};
+        if (mask) {
+            const __m512i m = _mm512_loadu_si512(mask + i);
+            sel = _mm512_test_epi8_mask(m, m);
+        }
+
+        __mmask64 clip = 0;
+        for (int c = 0; c < 3; ++c) {
+            __m512i v = _mm512_or_si512(
+                _mm512_or_si512(_mm512_shuffle_epi8(a0, shuf[c][0]), _mm512_shuffle_epi8(a1, shuf[c][1])),
+                _mm512_shuffle_epi8(a2, shuf[c][2]));
+            clip |= _mm512_cmple_epu8_mask(v, lo) | _mm512_cmpge_epu8_mask(v, hi);
+            v = _mm512_maskz_mov_epi8(sel, v);
+            sum[c] = _mm512_add_epi64(sum[c], _mm512_sad_epu8(v, zero));
+            const __m512i v_lo = _mm512_unpacklo_epi8(v, zero);
+            const __m512i v_hi = _mm512_unpackhi_epi8(v, zero);
+            sq32[c] = _mm512_add_epi32(sq32[c],
+                                       _mm512_add_epi32(_mm512_madd_epi16(v_lo, v_lo), _mm512_madd_epi16(v_hi, v_hi)));
+        }
+        clipped += static_cast<uint64_t>(_mm_popcnt_u64(clip & sel));
+        count += static_cast<uint64_t>(_mm_popcnt_u64(sel));
+
+        if (++blocks == kSquareFlushBlocks) {
+            blocks = 0;
+            for (int c = 0; c < 3; ++c) {
+                sq64[c] = widen_add(sq64[c], sq32[c]);
+                sq32[c] = zero;
+            }
+        }
+    }
+
+    for (int c = 0; c < 3; ++c) {
+        acc.sum[c] += hsum64(sum[c]);
+        acc.sum_sq[c] += hsum64(widen_add(sq64[c], sq32[c]));
+    }
+    acc.clipped += clipped;
+    acc.count += count;
+
+    if (i < n) {
+        accumulate_scalar(bgr, mask ? mask + i : nullptr, n - i, clip_lo, clip_hi, acc);
+    }
+}
+
+} // namespace roi_stats::detail
@@ -0,0 +1,65 @@
+// Built on AArch64 only, where Advanced SIMD is part of the baseline ISA.
+#include "RoiKernels.hpp"
+#include <arm_neon.h>
+
+namespace roi_stats::detail {
+
+void accumulate_neon(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi,
+                     Accum& acc) {
+    const uint8x16_t ones = vdupq_n_u8(0xFF);
+    const uint8x16_t lo = vdupq_n_u8(clip_lo);
+    const uint8x16_t hi = vdupq_n_u8(clip_hi);
+
+    uint64x2_t sum64[3] = {vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0)};
+    uint64x2_t sq64[3] = {vdupq_n_u64(0), vdupq_n_u64(0), vdupq_n_u64(0)};
+    uint32x4_t sum32[3] = {vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0)};
+    uint32x4_t sq32[3] = {vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0)};
+    uint64_t clipped = 0;
+    uint64_t count = 0;
+
+    size_t i = 0;
+    size_t blocks = 0;
+    for (; i + 16 <= n; i += 16, bgr += 48) {
+        const uint8x16x3_t px = vld3q_u8(bgr); // Deinterleaves B, G, R in the load
+        uint8x16_t sel = ones;
+        if (mask) {
+            const uint8x16_t m = vld1q_u8(mask + i);
+            sel = vtstq_u8(m, m);
+        }
+
+        uint8x16_t clip = vdupq_n_u8(0);
+        for (int c = 0; c < 3; ++c) {
+            uint8x16_t v = px.val[c];
+            clip = vorrq_u8(clip, vorrq_u8(vcleq_u8(v, lo), vcgeq_u8(v, hi)));
+            v = vandq_u8(v, sel);
+            sum32[c] = vpadalq_u16(sum32[c], vpaddlq_u8(v));
+            sq32[c] = vpadalq_u16(sq32[c], vmull_u8(vget_low_u8(v), vget_low_u8(v)));
+            sq32[c] = vpadalq_u16(sq32[c], vmull_high_u8(v, v));
+        }
+        clipped += vaddvq_u8(vshrq_n_u8(vandq_u8(clip, sel), 7));
+        count += vaddvq_u8(vshrq_n_u8(sel, 7));
+
+        if (++blocks == kSquareFlushBlocks) {
+            blocks = 0;
+            for (int c = 0; c < 3; ++c) {
+                sum64[c] = vpadalq_u32(sum64[c], sum32[c]);
+                sq64[c] = vpadalq_u32(sq64[c], sq32[c]);
+                sum32[c] = vdupq_n_u32(0);
+                sq32[c] = vdupq_n_u32(0);
+            }
+        }
+    }
+
+    for (int c = 0; c < 3; ++c) {
+        acc.sum[c] += vaddvq_u64(vpadalq_u32(sum64[c], sum32[c]));
+        acc.sum_sq[c] += vaddvq_u64(vpadalq_u32(sq64[c], sq32[c]));
+    }
+    acc.clipped += clipped;
+    acc.count += count;
+
+    if (i < n) {
+        accumulate_scalar(bgr, mask ? mask + i : nullptr, n - i, clip_lo, clip_hi, acc);
+    }
+}
+
+} // namespace roi_stats::detail
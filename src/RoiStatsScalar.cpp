@@ -0,0 +1,23 @@
+#include "RoiKernels.hpp"
+
+namespace roi_stats::detail {
+
+void accumulate_scalar(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi,
+                       Accum& acc) {
+    for (size_t i = 0; i < n; ++i, bgr += 3) {
+        if (mask && !mask[i]) {
+            continue;
+        }
+        bool clipped = false;
+        for (int c = 0; c < 3; ++c) {
+            const uint32_t v = bgr[c];
+            acc.sum[c] += v;
+            acc.sum_sq[c] += v * v;
+            clipped |= v <= clip_lo || v >= clip_hi;
+        }
+        acc.clipped += clipped ? 1 : 0;
+        ++acc.count;
+    }
+}
+
+} // namespace roi_stats::detail
@@ -0,0 +1,85 @@
+// Compiled with -msse4.2 -mpopcnt; only reached after CPUID confirms support.
+#include "RoiKernels.hpp"
+#include <nmmintrin.h>
+
+namespace roi_stats::detail {
+
+namespace {
+
+inline __m128i widen_add(__m128i acc64, __m128i v32) {
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_add_epi64(acc64, _mm_add_epi64(_mm_unpacklo_epi32(v32, zero), _mm_unpackhi_epi32(v32, zero)));
+}
+
+inline uint64_t hsum64(__m128i v) {
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(v)) + static_cast<uint64_t>(_mm_extract_epi64(v, 1));
+}
+
+} // namespace
+
+void accumulate_sse42(const uint8_t* bgr, const uint8_t* mask, size_t n, uint8_t clip_lo, uint8_t clip_hi,
+                      Accum& acc) {
+    __m128i shuf[3][3];
+    for (int c = 0; c < 3; ++c) {
+        for (int s = 0; s < 3; ++s) {
+            shuf[c][s] = _mm_load_si128(reinterpret_cast<const __m128i*>(kDeinterleave[c][s]));
+        }
+    }
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi8(-1);
+    const __m128i lo = _mm_set1_epi8(static_cast<char>(clip_lo));
+    const __m128i hi = _mm_set1_epi8(static_cast<char>(clip_hi));
+
+    __m128i sum[3] = {zero, zero, zero};
+    __m128i sq64[3] = {zero, zero, zero};
+    __m128i sq32[3] = {zero, zero, zero};
+    uint64_t clipped = 0;
+    uint64_t count = 0;
+
+    size_t i = 0;
+    size_t blocks = 0;
+    for (; i + 16 <= n; i += 16, bgr += 48) {
+        const __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr));
+        const __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + 16));
+        const __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgr + 32));
+        const __m128i sel =
+            mask ? _mm_xor_si128(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + i)), zero), ones)
+                 : ones;
+
+        __m128i clip = zero;
+        for (int c = 0; c < 3; ++c) {
+            __m128i v = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a0, shuf[c][0]), _mm_shuffle_epi8(a1, shuf[c][1])),
+                                     _mm_shuffle_epi8(a2, shuf[c][2]));
+            clip = _mm_or_si128(clip, _mm_cmpeq_epi8(_mm_min_epu8(v, lo), v)); // v <= lo
+            clip = _mm_or_si128(clip, _mm_cmpeq_epi8(_mm_max_epu8(v, hi), v)); // v >= hi
+            v = _mm_and_si128(v, sel);
+            sum[c] = _mm_add_epi64(sum[c], _mm_sad_epu8(v, zero));
+            const __m128i v_lo = _mm_unpacklo_epi8(v, zero);
+            const __m128i v_hi = _mm_unpackhi_epi8(v, zero);
+            sq32[c] = _mm_add_epi32(sq32[c], _mm_add_epi32(_mm_madd_epi16(v_lo, v_lo), _mm_madd_epi16(v_hi, v_hi)));
+        }
+        clipped += static_cast<uint64_t>(_mm_popcnt_u32(static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(clip, sel)))));
+        count += static_cast<uint64_t>(_mm_popcnt_u32(static_cast<uint32_t>(_mm_movemask_epi8(sel))));
+
+        if (++blocks == kSquareFlushBlocks) {
+            blocks = 0;
+            for (int c = 0; c < 3; ++c) {
+                sq64[c] = widen_add(sq64[c], sq32[c]);
+                sq32[c] = zero;
+            }
+        }
+    }
+
+    for (int c = 0; c < 3; ++c) {
+        acc.sum[c] += hsum64(sum[c]);
+        acc.sum_sq[c] += hsum64(widen_add(sq64[c], sq32[c]));
+    }
+    acc.clipped += clipped;
+    acc.count += count;
+
+    if (i < n) {
+        accumulate_scalar(bgr, mask ? mask + i : nullptr, n - i, clip_lo, clip_hi, acc);
+    }
+}
+
+} // namespace roi_stats::detail
@@ -0,0 +1,364 @@
+#include "SessionRecording.hpp"
+#include <bit>
+#include <cstring>
+#include <format>
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+static_assert(std::endian::native == std::endian::little, "Session files are written in native little-endian order");
+
+constexpr char kFileMagic[8] = {'H', 'B', 'M', 'S', 'E', 'S', 'S', '1'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kChunkMagic = 0x434D4248; // "HBMC"
+constexpr size_t kFileHeaderBytes = sizeof(kFileMagic) + 2 * sizeof(uint32_t) + 4 * sizeof(double) + sizeof(int64_t);
+constexpr size_t kChunkHeaderBytes = 4 * sizeof(uint32_t);
+constexpr size_t kColumnHeaderBytes = 2 * sizeof(uint16_t) + sizeof(uint32_t);
+
+enum class Kind : uint16_t { Int = 1, Float = 2 };
+
+// Column ids are stable on disk; new fields get new ids and old readers skip them
+constexpr uint16_t kColT = 0, kColFace = 1, kColBgr = 2, kColBox = 5, kColAnchors = 9, kColBpm = 15,
+                   kColConfidence = 16, kColStages = 17;
+constexpr uint16_t kColumnCount = kColStages + static_cast<uint16_t>(kSessionStages.size());
+
+Kind column_kind(uint16_t id) {
+    return (id >= kColBgr && id < kColBox) || id == kColBpm || id == kColConfidence ? Kind::Float : Kind::Int;
+}
+
+uint64_t get_column(const SessionFrame& f, uint16_t id) {
+    if (id == kColT) return static_cast<uint64_t>(f.t_ns);
+    if (id == kColFace) return f.face ? 1 : 0;
+    if (id < kColBox) return std::bit_cast<uint64_t>(f.bgr[id - kColBgr]);
+    if (id < kColAnchors) return static_cast<uint64_t>(static_cast<int64_t>(f.box[id - kColBox]));
+    if (id < kColBpm) return static_cast<uint64_t>(static_cast<int64_t>(f.anchors[id - kColAnchors]));
+    if (id == kColBpm) return std::bit_cast<uint64_t>(f.bpm);
+    if (id == kColConfidence) return std::bit_cast<uint64_t>(f.confidence);
+    return f.stage_us[id - kColStages];
+}
+
+void set_column(SessionFrame& f, uint16_t id, uint64_t v) {
+    if (id == kColT) f.t_ns = static_cast<int64_t>(v);
+    else if (id == kColFace) f.face = v != 0;
+    else if (id < kColBox) f.bgr[id - kColBgr] = std::bit_cast<double>(v);
+    else if (id < kColAnchors) f.box[id - kColBox] = static_cast<int32_t>(static_cast<int64_t>(v));
+    else if (id < kColBpm) f.anchors[id - kColAnchors] = static_cast<int32_t>(static_cast<int64_t>(v));
+    else if (id == kColBpm) f.bpm = std::bit_cast<double>(v);
+    else if (id == kColConfidence) f.confidence = std::bit_cast<double>(v);
+    else if (id < kColumnCount) f.stage_us[id - kColStages] = static_cast<uint32_t>(v);
+}
+
+template <typename T>
+void put(std::vector<uint8_t>& buf, T v) {
+    const size_t at = buf.size();
+    buf.resize(at + sizeof(T));
+    std::memcpy(buf.data() + at, &v, sizeof(T));
+}
+
+template <typename T>
+T get(const uint8_t* p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+void put_varint(std::vector<uint8_t>& buf, uint64_t v) {
+    while (v >= 0x80) {
+        buf.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    buf.push_back(static_cast<uint8_t>(v));
+}
+
+bool get_varint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        const uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Ints: zigzag(delta) so slowly varying timestamps/coordinates take 1-2 bytes.
+// Floats: XOR with the previous bit pattern, so repeats (NaN bpm, zero bgr) take 1 byte.
+uint64_t encode_value(Kind kind, uint64_t v, uint64_t prev) {
+    if (kind == Kind::Float) {
+        return v ^ prev;
+    }
+    const auto d = static_cast<int64_t>(v - prev);
+    return (static_cast<uint64_t>(d) << 1) ^ static_cast<uint64_t>(d >> 63);
+}
+
+uint64_t decode_value(Kind kind, uint64_t coded, uint64_t prev) {
+    if (kind == Kind::Float) {
+        return coded ^ prev;
+    }
+    const uint64_t d = (coded >> 1) ^ (~(coded & 1) + 1);
+    return prev + d;
+}
+
+void encode_chunk(const std::vector<SessionFrame>& rows, std::vector<uint8_t>& buf) {
+    buf.clear();
+    put(buf, kChunkMagic);
+    put(buf, static_cast<uint32_t>(rows.size()));
+    put(buf, static_cast<uint32_t>(kColumnCount));
+    put(buf, uint32_t{0}); // Payload size, patched below
+    for (uint16_t id = 0; id < kColumnCount; ++id) {
+        const Kind kind = column_kind(id);
+        put(buf, id);
+        put(buf, static_cast<uint16_t>(kind));
+        const size_t size_at = buf.size();
+        put(buf, uint32_t{0});
+        uint64_t prev = 0;
+        for (const auto& row : rows) {
+            const uint64_t v = get_column(row, id);
+            put_varint(buf, encode_value(kind, v, prev));
+            prev = v;
+        }
+        const auto bytes = static_cast<uint32_t>(buf.size() - size_at - sizeof(uint32_t));
+        std::memcpy(buf.data() + size_at, &bytes, sizeof(bytes));
+    }
+    const auto payload = static_cast<uint32_t>(buf.size() - kChunkHeaderBytes);
+    std::memcpy(buf.data() + 3 * sizeof(uint32_t), &payload, sizeof(payload));
+}
+
+std::expected<std::shared_ptr<const uint8_t>, std::string> map_file(const std::filesystem::path& path, size_t& size) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return std::unexpected("Cannot open " + path.string());
+    }
+    LARGE_INTEGER file_size{};
+    GetFileSizeEx(file, &file_size);
+    size = static_cast<size_t>(file_size.QuadPart);
+    HANDLE mapping = size ? CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+    CloseHandle(file);
+    if (!mapping) {
+        return std::unexpected("CreateFileMapping failed for " + path.string());
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // The view keeps the mapping alive
+    if (!view) {
+        return std::unexpected("MapViewOfFile failed for " + path.string());
+    }
+    return std::shared_ptr<const uint8_t>(static_cast<const uint8_t*>(view),
+                                          [](const uint8_t* p) { UnmapViewOfFile(p); });
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::unexpected("Cannot open " + path.string() + ": " + std::strerror(errno));
+    }
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return std::unexpected("Empty or unreadable session file " + path.string());
+    }
+    size = static_cast<size_t>(st.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        return std::unexpected("mmap failed for " + path.string() + ": " + std::strerror(errno));
+    }
+    return std::shared_ptr<const uint8_t>(static_cast<const uint8_t*>(view),
+                                          [size](const uint8_t* p) { munmap(const_cast<uint8_t*>(p), size); });
+#endif
+}
+} // namespace
+
+std::expected<std::unique_ptr<SessionRecorder>, std::string> SessionRecorder::create(
+    const std::filesystem::path& path, const SessionHeader& header, const Options& options) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return std::unexpected("Cannot create " + path.string());
+    }
+    std::vector<uint8_t> buf;
+    buf.insert(buf.end(), std::begin(kFileMagic), std::end(kFileMagic));
+    put(buf, kVersion);
+    put(buf, static_cast<uint32_t>(kFileHeaderBytes));
+    put(buf, header.acquisition_fps);
+    put(buf, header.window_seconds);
+    put(buf, header.min_bpm);
+    put(buf, header.max_bpm);
+    put(buf, header.start_unix_ns);
+    out.write(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(buf.size()));
+    out.flush();
+    if (!out) {
+        return std::unexpected("Cannot write header to " + path.string());
+    }
+    Options opts = options;
+    opts.chunk_frames = std::max<size_t>(1, opts.chunk_frames);
+    opts.max_pending_chunks = std::max<size_t>(1, opts.max_pending_chunks);
+    return std::unique_ptr<SessionRecorder>(new SessionRecorder(std::move(out), opts));
+}
+
+SessionRecorder::SessionRecorder(std::ofstream out, const Options& options)
+    : m_out(std::move(out)),
+      m_options(options),
+      m_writer([this](std::stop_token st) { write_loop(st); }) {
+    m_active.reserve(m_options.chunk_frames);
+}
+
+SessionRecorder::~SessionRecorder() {
+    if (!m_active.empty()) {
+        std::lock_guard lock(m_mtx);
+        m_pending.push_back(std::move(m_active));
+    }
+    m_writer.request_stop(); // Wakes the writer, which drains everything pending before exiting
+    m_writer.join();
+}
+
+void SessionRecorder::append(const SessionFrame& frame) {
+    m_active.push_back(frame);
+    if (m_active.size() >= m_options.chunk_frames) {
+        submit(std::exchange(m_active, {}));
+        m_active.reserve(m_options.chunk_frames);
+    }
+}
+
+void SessionRecorder::submit(std::vector<SessionFrame> chunk) {
+    {
+        std::lock_guard lock(m_mtx);
+        if (m_pending.size() >= m_options.max_pending_chunks) {
+            m_frames_dropped.fetch_add(chunk.size(), std::memory_order_relaxed);
+            return;
+        }
+        m_pending.push_back(std::move(chunk));
+    }
+    m_cv.notify_one();
+}
+
+void SessionRecorder::write_loop(std::stop_token st) {
+    std::vector<uint8_t> buf;
+    while (true) {
+        std::vector<SessionFrame> chunk;
+        {
+            std::unique_lock lock(m_mtx);
+            if (!m_cv.wait(lock, st, [this] { return !m_pending.empty(); })) {
+                return; // Stop requested and nothing left to write
+            }
+            chunk = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+        encode_chunk(chunk, buf);
+        if (!m_out) {
+            m_frames_dropped.fetch_add(chunk.size(), std::memory_order_relaxed);
+            continue;
+        }
+        m_out.write(reinterpret_cast<const char*>(buf.data()), static_cast<std::streamsize>(buf.size()));
+        m_out.flush();
+        if (!m_out) {
+            spdlog::warn("Session recording stopped: write failed");
+            m_frames_dropped.fetch_add(chunk.size(), std::memory_order_relaxed);
+            continue;
+        }
+        m_frames_written.fetch_add(chunk.size(), std::memory_order_relaxed);
+        m_bytes_written.fetch_add(buf.size(), std::memory_order_relaxed);
+    }
+}
+
+std::expected<SessionReader, std::string> SessionReader::open(const std::filesystem::path& path) {
+    SessionReader reader;
+    auto map = map_file(path, reader.m_size);
+    if (!map) {
+        return std::unexpected(map.error());
+    }
+    reader.m_map = std::move(*map);
+    const uint8_t* data = reader.m_map.get();
+    if (reader.m_size < kFileHeaderBytes || std::memcmp(data, kFileMagic, sizeof(kFileMagic)) != 0) {
+        return std::unexpected(path.string() + " is not a session file");
+    }
+    const auto version = get<uint32_t>(data + 8);
+    const auto header_bytes = get<uint32_t>(data + 12);
+    if (version != kVersion || header_bytes < kFileHeaderBytes || header_bytes > reader.m_size) {
+        return std::unexpected(std::format("Unsupported session file version {} in {}", version, path.string()));
+    }
+    reader.m_header.acquisition_fps = get<double>(data + 16);
+    reader.m_header.window_seconds = get<double>(data + 24);
+    reader.m_header.min_bpm = get<double>(data + 32);
+    reader.m_header.max_bpm = get<double>(data + 40);
+    reader.m_header.start_unix_ns = get<int64_t>(data + 48);
+
+    size_t offset = header_bytes;
+    while (offset < reader.m_size) {
+        if (reader.m_size - offset < kChunkHeaderBytes || get<uint32_t>(data + offset) != kChunkMagic) {
+            reader.m_truncated = true;
+            break;
+        }
+        const auto rows = get<uint32_t>(data + offset + 4);
+        const auto payload = get<uint32_t>(data + offset + 12);
+        if (reader.m_size - offset - kChunkHeaderBytes < payload) {
+            reader.m_truncated = true;
+            break;
+        }
+        reader.m_chunks.push_back({offset, kChunkHeaderBytes + payload, rows});
+        reader.m_frames += rows;
+        offset += kChunkHeaderBytes + payload;
+    }
+    return reader;
+}
+
+std::expected<void, std::string> SessionReader::read_chunk(size_t index, std::vector<SessionFrame>& out) const {
+    if (index >= m_chunks.size()) {
+        return std::unexpected(std::format("Chunk {} out of range ({})", index, m_chunks.size()));
+    }
+    const ChunkRef& ref = m_chunks[index];
+    const uint8_t* p = m_map.get() + ref.offset;
+    const uint8_t* end = p + ref.bytes;
+    const auto columns = get<uint32_t>(p + 8);
+    p += kChunkHeaderBytes;
+    out.assign(ref.rows, SessionFrame{});
+    for (uint32_t c = 0; c < columns; ++c) {
+        if (end - p < static_cast<std::ptrdiff_t>(kColumnHeaderBytes)) {
+            return std::unexpected(std::format("Chunk {} column table is cut short", index));
+        }
+        const auto id = get<uint16_t>(p);
+        const auto kind = static_cast<Kind>(get<uint16_t>(p + 2));
+        const auto bytes = get<uint32_t>(p + 4);
+        p += kColumnHeaderBytes;
+        if (end - p < static_cast<std::ptrdiff_t>(bytes)) {
+            return std::unexpected(std::format("Chunk {} column {} is cut short", index, id));
+        }
+        const uint8_t* col = p;
+        const uint8_t* col_end = p + bytes;
+        p = col_end;
+        if (id >= kColumnCount || kind != column_kind(id)) {
+            continue; // Written by a newer recorder
+        }
+        uint64_t prev = 0;
+        for (auto& row : out) {
+            uint64_t coded = 0;
+            if (!get_varint(col, col_end, coded)) {
+                return std::unexpected(std::format("Chunk {} column {} has a bad varint", index, id));
+            }
+            prev = decode_value(kind, coded, prev);
+            set_column(row, id, prev);
+        }
+    }
+    return {};
+}
+
+std::expected<std::vector<SessionFrame>, std::string> SessionReader::read_all() const {
+    std::vector<SessionFrame> all;
+    all.reserve(m_frames);
+    std::vector<SessionFrame> chunk;
+    for (size_t i = 0; i < m_chunks.size(); ++i) {
+        if (auto ok = read_chunk(i, chunk); !ok) {
+            return std::unexpected(ok.error());
+        }
+        all.insert(all.end(), chunk.begin(), chunk.end());
+    }
+    return all;
+}
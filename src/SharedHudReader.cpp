@@ -0,0 +1,52 @@
+#include "SharedHudReader.hpp"
+#include <bit>
+
+std::expected<SharedHudReader, std::string> SharedHudReader::open(const std::string& name) {
+    auto region = SharedMemoryRegion::open_read_only(name, shm_hud::kBlockSize);
+    if (!region) {
+        return std::unexpected(region.error());
+    }
+    const auto* block = static_cast<const shm_hud::Block*>(region->data());
+    if (block->header.magic != shm_hud::kMagic || block->header.version != shm_hud::kVersion) {
+        return std::unexpected("Shared HUD channel '" + name + "' has an incompatible layout");
+    }
+    return SharedHudReader(std::move(*region));
+}
+
+bool SharedHudReader::read(HudSample& out) const {
+    const auto& h = block().header;
+    constexpr int kRetries = 64;
+    for (int attempt = 0; attempt < kRetries; ++attempt) {
+        const uint32_t s0 = h.seq.load(std::memory_order_acquire);
+        if (s0 & 1u) {
+            continue; // Writer is mid-update
+        }
+        const uint32_t flags = h.flags.load(std::memory_order_relaxed);
+        out.bpm_valid = (flags & shm_hud::kFlagBpmValid) != 0;
+        out.bpm = std::bit_cast<double>(h.bpm_bits.load(std::memory_order_relaxed));
+        out.confidence = std::bit_cast<double>(h.confidence_bits.load(std::memory_order_relaxed));
+        out.timestamp_ns = h.timestamp_ns.load(std::memory_order_relaxed);
+        out.update_count = h.update_count.load(std::memory_order_relaxed);
+        const bool preview = (flags & shm_hud::kFlagPreviewValid) != 0;
+        out.preview_width = preview ? h.preview_width.load(std::memory_order_relaxed) : 0;
+        out.preview_height = preview ? h.preview_height.load(std::memory_order_relaxed) : 0;
+        out.preview_stride = preview ? h.preview_stride.load(std::memory_order_relaxed) : 0;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (h.seq.load(std::memory_order_relaxed) == s0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::optional<HudSample> SharedHudReader::poll() {
+    if (block().header.update_count.load(std::memory_order_relaxed) == m_last_update) {
+        return std::nullopt;
+    }
+    HudSample sample;
+    if (!read(sample)) {
+        return std::nullopt;
+    }
+    m_last_update = sample.update_count;
+    return sample;
+}
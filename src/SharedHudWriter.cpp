@@ -0,0 +1,77 @@
+#include "SharedHudWriter.hpp"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+namespace {
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+} // namespace
+
+std::expected<SharedHudWriter, std::string> SharedHudWriter::create(const std::string& name, cv::Size preview_size) {
+    auto region = SharedMemoryRegion::create(name, shm_hud::kBlockSize);
+    if (!region) {
+        return std::unexpected(region.error());
+    }
+    return SharedHudWriter(std::move(*region), preview_size);
+}
+
+SharedHudWriter::SharedHudWriter(SharedMemoryRegion region, cv::Size preview_size)
+    : m_region(std::move(region)),
+      m_preview_size(std::clamp<int>(preview_size.width, 0, shm_hud::kMaxPreviewWidth),
+                     std::clamp<int>(preview_size.height, 0, shm_hud::kMaxPreviewHeight)) {
+    auto& h = header();
+    h.seq.store(0, std::memory_order_relaxed);
+    h.flags.store(0, std::memory_order_relaxed);
+    h.update_count.store(0, std::memory_order_relaxed);
+    h.version = shm_hud::kVersion;
+    // Magic last: readers treat the block as valid once it matches
+    std::atomic_thread_fence(std::memory_order_release);
+    h.magic = shm_hud::kMagic;
+}
+
+template <typename F>
+void SharedHudWriter::write(F&& update) {
+    auto& h = header();
+    const uint32_t s = h.seq.load(std::memory_order_relaxed);
+    h.seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    update(h);
+    h.timestamp_ns.store(now_ns(), std::memory_order_relaxed);
+    h.update_count.fetch_add(1, std::memory_order_relaxed);
+    h.seq.store(s + 2, std::memory_order_release);
+}
+
+void SharedHudWriter::publish_bpm(double bpm, double confidence) {
+    write([&](shm_hud::Header& h) {
+        h.bpm_bits.store(std::bit_cast<uint64_t>(bpm), std::memory_order_relaxed);
+        h.confidence_bits.store(std::bit_cast<uint64_t>(confidence), std::memory_order_relaxed);
+        h.flags.fetch_or(shm_hud::kFlagBpmValid, std::memory_order_relaxed);
+    });
+}
+
+void SharedHudWriter::publish_preview(const cv::Mat& bgr) {
+    if (bgr.empty() || m_preview_size.area() == 0) {
+        return;
+    }
+    const double scale = std::min(static_cast<double>(m_preview_size.width) / bgr.cols,
+                                  static_cast<double>(m_preview_size.height) / bgr.rows);
+    const cv::Size size(std::clamp(static_cast<int>(std::lround(bgr.cols * scale)), 1, m_preview_size.width),
+                        std::clamp(static_cast<int>(std::lround(bgr.rows * scale)), 1, m_preview_size.height));
+    cv::resize(bgr, m_scaled, size, 0, 0, cv::INTER_AREA);
+
+    auto* block = static_cast<shm_hud::Block*>(m_region.data());
+    const size_t stride = static_cast<size_t>(size.width) * 4;
+    cv::Mat shared(size, CV_8UC4, block->preview, stride);
+    write([&](shm_hud::Header& h) {
+        cv::cvtColor(m_scaled, shared, cv::COLOR_BGR2BGRA);
+        h.preview_width.store(static_cast<uint32_t>(size.width), std::memory_order_relaxed);
+        h.preview_height.store(static_cast<uint32_t>(size.height), std::memory_order_relaxed);
+        h.preview_stride.store(static_cast<uint32_t>(stride), std::memory_order_relaxed);
+        h.flags.fetch_or(shm_hud::kFlagPreviewValid, std::memory_order_relaxed);
+    });
+}
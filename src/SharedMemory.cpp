@@ -0,0 +1,140 @@
+#include "SharedMemory.hpp"
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+std::string mapping_name(const std::string& name) {
+    return "Local\\" + name;
+}
+#else
+std::string mapping_name(const std::string& name) {
+    return name.starts_with('/') ? name : "/" + name;
+}
+
+std::string errno_text(const char* what, const std::string& name) {
+    return std::string(what) + " '" + name + "': " + std::strerror(errno);
+}
+#endif
+} // namespace
+
+std::expected<SharedMemoryRegion, std::string> SharedMemoryRegion::create(const std::string& name, size_t size) {
+    SharedMemoryRegion region;
+    const std::string full = mapping_name(name);
+#ifdef _WIN32
+    const auto size64 = static_cast<unsigned long long>(size);
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                        static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFFu),
+                                        full.c_str());
+    if (!mapping) {
+        return std::unexpected("CreateFileMapping failed for '" + full + "'");
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+        CloseHandle(mapping);
+        return std::unexpected("MapViewOfFile failed for '" + full + "'");
+    }
+    region.m_handle = mapping;
+    region.m_data = view;
+#else
+    const int fd = shm_open(full.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        return std::unexpected(errno_text("shm_open", full));
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        auto err = errno_text("ftruncate", full);
+        close(fd);
+        return std::unexpected(err);
+    }
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        return std::unexpected(errno_text("mmap", full));
+    }
+    region.m_data = view;
+    region.m_unlink_name = full;
+#endif
+    region.m_size = size;
+    return region;
+}
+
+std::expected<SharedMemoryRegion, std::string> SharedMemoryRegion::open_read_only(const std::string& name, size_t size) {
+    SharedMemoryRegion region;
+    const std::string full = mapping_name(name);
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, full.c_str());
+    if (!mapping) {
+        return std::unexpected("No shared HUD channel named '" + full + "'");
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    if (!view) {
+        CloseHandle(mapping);
+        return std::unexpected("MapViewOfFile failed for '" + full + "'");
+    }
+    region.m_handle = mapping;
+    region.m_data = view;
+#else
+    const int fd = shm_open(full.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return std::unexpected(errno_text("shm_open", full));
+    }
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < size) {
+        close(fd);
+        return std::unexpected("Shared HUD channel '" + full + "' is too small");
+    }
+    void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        return std::unexpected(errno_text("mmap", full));
+    }
+    region.m_data = view;
+#endif
+    region.m_size = size;
+    return region;
+}
+
+SharedMemoryRegion::SharedMemoryRegion(SharedMemoryRegion&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)),
+      m_size(std::exchange(other.m_size, 0)),
+      m_handle(std::exchange(other.m_handle, nullptr)),
+      m_unlink_name(std::exchange(other.m_unlink_name, {})) {}
+
+SharedMemoryRegion& SharedMemoryRegion::operator=(SharedMemoryRegion&& other) noexcept {
+    if (this != &other) {
+        reset();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_handle = std::exchange(other.m_handle, nullptr);
+        m_unlink_name = std::exchange(other.m_unlink_name, {});
+    }
+    return *this;
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    reset();
+}
+
+void SharedMemoryRegion::reset() {
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_handle) CloseHandle(static_cast<HANDLE>(m_handle));
+#else
+    if (m_data) munmap(m_data, m_size);
+    if (!m_unlink_name.empty()) shm_unlink(m_unlink_name.c_str());
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_handle = nullptr;
+    m_unlink_name.clear();
+}
@@ -0,0 +1,76 @@
+#include "TraceRecorder.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <spdlog/fmt/fmt.h>
+
+namespace {
+std::string json_escape(std::string_view s) {
+    std::string out;
+    out.reserve(s.size());
+    for (const char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out += fmt::format("\\u{:04x}", static_cast<unsigned>(c));
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+} // namespace
+
+TraceRecorder::TraceRecorder(size_t capacity) : m_events(std::max<size_t>(1, capacity)) {}
+
+void TraceRecorder::on_zone(const instr::ThreadBuffer& thread, const instr::ZoneEvent& event) {
+    std::lock_guard lock(m_mtx);
+    m_events[m_written % m_events.size()] = {event.start_ns, event.end_ns, thread.index, event.zone};
+    ++m_written;
+}
+
+std::expected<size_t, std::string> TraceRecorder::write_chrome_json(const std::string& path) const {
+    // Copy out under the lock; formatting and file I/O happen without blocking the collector
+    std::vector<Event> events;
+    {
+        std::lock_guard lock(m_mtx);
+        const size_t cap = m_events.size();
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(m_written, cap));
+        events.reserve(count);
+        for (uint64_t i = m_written - count; i < m_written; ++i) {
+            events.push_back(m_events[i % cap]);
+        }
+    }
+    std::ranges::sort(events, {}, &Event::start_ns);
+
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        return std::unexpected("Cannot open trace file: " + path);
+    }
+    const int64_t origin = events.empty() ? 0 : events.front().start_ns;
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out += R"({"ph":"M","pid":1,"tid":0,"name":"process_name","args":{"name":"HeartbeatMonitor"}})";
+    for (const auto& thread : instr::threads()) {
+        out += fmt::format(",\n{{\"ph\":\"M\",\"pid\":1,\"tid\":{},\"name\":\"thread_name\",\"args\":{{\"name\":\"{}\"}}}}",
+                           thread->index, json_escape(instr::thread_name(*thread)));
+    }
+    for (const Event& e : events) {
+        // Complete events: begin timestamp plus duration, in microseconds
+        out += fmt::format(",\n{{\"ph\":\"X\",\"pid\":1,\"tid\":{},\"name\":\"{}\",\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                           e.thread, json_escape(instr::zone_name(e.zone)),
+                           static_cast<double>(e.start_ns - origin) / 1e3,
+                           static_cast<double>(e.end_ns - e.start_ns) / 1e3);
+        if (out.size() > (1u << 20)) {
+            std::fwrite(out.data(), 1, out.size(), f);
+            out.clear();
+        }
+    }
+    out += "\n]}\n";
+    std::fwrite(out.data(), 1, out.size(), f);
+    const bool ok = std::ferror(f) == 0;
+    std::fclose(f);
+    if (!ok) {
+        return std::unexpected("Failed writing trace file: " + path);
+    }
+    return events.size();
+}
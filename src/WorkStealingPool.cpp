@@ -0,0 +1,248 @@
+#include "WorkStealingPool.hpp"
+#include <algorithm>
+#include <exception>
+#include <spdlog/spdlog.h>
+#include "Instrumentation.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+thread_local const WorkStealingPool* t_pool = nullptr;
+thread_local int t_index = -1;
+
+bool pin_current_thread(unsigned core) {
+#ifdef _WIN32
+    return core < 64 && SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR{1} << core) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false; // macOS has no hard affinity
+#endif
+}
+} // namespace
+
+WorkStealingPool::WorkStealingPool(unsigned threads) : WorkStealingPool(Options{.threads = threads}) {}
+
+WorkStealingPool::WorkStealingPool(const Options& options) : m_options(options) {
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned threads = options.threads ? options.threads : cores;
+    for (unsigned i = 0; i < threads; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (unsigned i = 0; i < threads; ++i) {
+        m_threads.emplace_back([this, i, cores] {
+            if (m_options.pin_workers && !pin_current_thread((m_options.first_core + i) % cores)) {
+                spdlog::warn("{}-{}: could not pin to core {}", m_options.name, i, (m_options.first_core + i) % cores);
+            }
+            run(i);
+        });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait_idle();
+    {
+        std::lock_guard lock(m_park_mtx);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    m_threads.clear();
+}
+
+void WorkStealingPool::submit(Task task, Priority priority) {
+    enqueue(std::move(task), current_worker(), priority);
+}
+
+void WorkStealingPool::inject(Task task, Priority priority) {
+    enqueue(std::move(task), -1, priority);
+}
+
+void WorkStealingPool::enqueue(Task task, int worker, Priority priority) {
+    const size_t level = static_cast<size_t>(priority);
+    // Counted before the push so a worker never parks while a task it cannot see yet is on its way
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    m_queued_at[level].fetch_add(1, std::memory_order_relaxed);
+    m_queued.fetch_add(1, std::memory_order_seq_cst);
+    if (worker >= 0) {
+        Worker& w = *m_workers[static_cast<size_t>(worker)];
+        std::lock_guard lock(w.mtx);
+        w.tasks[level].push_back(std::move(task));
+    } else {
+        m_injected_count.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard lock(m_inject_mtx);
+        m_injected[level].push_back(std::move(task));
+    }
+    // Pairs with the parked increment in run(): either we see the sleeper, or it sees m_queued
+    if (m_parked.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard lock(m_park_mtx);
+        m_wake.notify_one();
+    }
+}
+
+bool WorkStealingPool::try_pop(int self, Task& out) {
+    const size_t n = m_workers.size();
+    for (size_t level = 0; level < kPriorities; ++level) {
+        if (m_queued_at[level].load(std::memory_order_acquire) == 0) {
+            continue;
+        }
+        if (self >= 0) {
+            Worker& w = *m_workers[static_cast<size_t>(self)];
+            std::lock_guard lock(w.mtx);
+            if (!w.tasks[level].empty()) {
+                out = std::move(w.tasks[level].back());
+                w.tasks[level].pop_back();
+                m_queued_at[level].fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        {
+            std::lock_guard lock(m_inject_mtx);
+            if (!m_injected[level].empty()) {
+                out = std::move(m_injected[level].front());
+                m_injected[level].pop_front();
+                m_queued_at[level].fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        const size_t first = self >= 0 ? static_cast<size_t>(self) + 1 : 0;
+        for (size_t k = 0; k < n; ++k) {
+            const size_t victim_index = (first + k) % n;
+            if (static_cast<int>(victim_index) == self) {
+                continue;
+            }
+            Worker& victim = *m_workers[victim_index];
+            std::lock_guard lock(victim.mtx);
+            if (!victim.tasks[level].empty()) {
+                out = std::move(victim.tasks[level].front());
+                victim.tasks[level].pop_front();
+                m_queued_at[level].fetch_sub(1, std::memory_order_relaxed);
+                m_stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::execute(Task& task) {
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+    try {
+        task();
+    } catch (const std::exception& e) {
+        spdlog::error("{} task failed: {}", m_options.name, e.what());
+    }
+    task = nullptr; // Release captures before the task counts as finished
+    m_executed.fetch_add(1, std::memory_order_relaxed);
+    if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard lock(m_idle_mtx);
+        m_idle.notify_all();
+    }
+}
+
+bool WorkStealingPool::run_one() {
+    Task task;
+    if (!try_pop(current_worker(), task)) {
+        return false;
+    }
+    execute(task);
+    return true;
+}
+
+void WorkStealingPool::run(unsigned index) {
+    t_pool = this;
+    t_index = static_cast<int>(index);
+    HBM_THREAD_NAME(m_options.name + "-" + std::to_string(index));
+    Task task;
+    for (;;) {
+        if (try_pop(t_index, task)) {
+            execute(task);
+            continue;
+        }
+        // Frame-rate workloads come in bursts; a short spin avoids a park/unpark per task
+        const auto spin_until = std::chrono::steady_clock::now() + m_options.spin;
+        bool found = false;
+        while (!found && std::chrono::steady_clock::now() < spin_until) {
+            std::this_thread::yield();
+            found = m_queued.load(std::memory_order_acquire) > 0 && try_pop(t_index, task);
+        }
+        if (found) {
+            execute(task);
+            continue;
+        }
+        std::unique_lock lock(m_park_mtx);
+        m_parked.fetch_add(1, std::memory_order_seq_cst);
+        if (!m_stop && m_queued.load(std::memory_order_seq_cst) == 0) {
+            m_parks.fetch_add(1, std::memory_order_relaxed);
+            m_wake.wait(lock, [&] { return m_stop || m_queued.load(std::memory_order_seq_cst) > 0; });
+        }
+        m_parked.fetch_sub(1, std::memory_order_relaxed);
+        if (m_stop && m_queued.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+void WorkStealingPool::wait_idle() {
+    std::unique_lock lock(m_idle_mtx);
+    m_idle.wait(lock, [&] { return m_pending.load(std::memory_order_acquire) == 0; });
+}
+
+int WorkStealingPool::current_worker() const {
+    return t_pool == this ? t_index : -1;
+}
+
+WorkStealingPool::Stats WorkStealingPool::stats() const {
+    return {m_executed.load(std::memory_order_relaxed), m_stolen.load(std::memory_order_relaxed),
+            m_injected_count.load(std::memory_order_relaxed), m_parks.load(std::memory_order_relaxed)};
+}
+
+TaskGroup::TaskGroup(WorkStealingPool& pool, WorkStealingPool::Priority priority)
+    : m_pool(pool),
+      m_priority(priority) {}
+
+TaskGroup::~TaskGroup() {
+    wait();
+}
+
+void TaskGroup::run(WorkStealingPool::Task task) {
+    m_remaining.fetch_add(1, std::memory_order_relaxed);
+    m_pool.submit([this, task = std::move(task)]() mutable {
+        struct Done {
+            TaskGroup* group;
+            ~Done() { group->finish_one(); }
+        } done{this}; // Also on throw, so wait() cannot hang on a failed task
+        task();
+    }, m_priority);
+}
+
+void TaskGroup::finish_one() {
+    // Decremented under the lock so wait() cannot return (and the group be destroyed) mid-notify
+    std::lock_guard lock(m_mtx);
+    if (m_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        m_done.notify_all();
+    }
+}
+
+void TaskGroup::wait() {
+    if (m_pool.current_worker() >= 0) {
+        // On a worker: help instead of blocking it (the group's own tasks may be in our deque)
+        while (m_remaining.load(std::memory_order_acquire) > 0) {
+            if (!m_pool.run_one()) {
+                std::this_thread::yield();
+            }
+        }
+        std::lock_guard lock(m_mtx); // The last finisher may still be inside finish_one()
+        return;
+    }
+    std::unique_lock lock(m_mtx);
+    m_done.wait(lock, [&] { return m_remaining.load(std::memory_order_acquire) == 0; });
+}
@@ -1,80 +1,30 @@
 #include <print>
+#include <format>
 #include <thread>
 #include <chrono>
-#include <cmath>
 #include <algorithm>
+#include <optional>
+#include <filesystem>
+#include <memory>
+#include <vector>
 #include <spdlog/spdlog.h>
 
-namespace {
-struct RunningStats {
-    size_t count{0};
-    double mean{0.0};
-    double m2{0.0};
-    double min{0.0};
-    double max{0.0};
-
-    void add(double x) {
-        if (count == 0) {
-            min = max = x;
-        } else {
-            min = std::min(min, x);
-            max = std::max(max, x);
-        }
-        ++count;
-        const double delta = x - mean;
-        mean += delta / static_cast<double>(count);
-        const double delta2 = x - mean;
-        m2 += delta * delta2;
-    }
-
-    double variance() const {
-        return (count > 1) ? (m2 / static_cast<double>(count - 1)) : 0.0;
-    }
-};
-} // namespace
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
-#include "FaceProcessor.hpp"
-#include "HeartbeatAnalyzer.hpp"
+#include "CameraPipeline.hpp"
+#include "DebugVisualizer.hpp"
+#include "FaceModel.hpp"
+#include "Instrumentation.hpp"
+#include "MatPool.hpp"
+#include "Logging.hpp"
+#include "MetricsServer.hpp"
 #include "Overlay.hpp"
+#include "SessionRecording.hpp"
+#include "SharedHudWriter.hpp"
+#include "TraceRecorder.hpp"
+#include "WorkStealingPool.hpp"
 
 
-namespace {
-cv::Mat resize_plot_to_fit(const cv::Mat& plot, int max_w, int max_h) {
-    if (plot.empty() || max_w <= 0 || max_h <= 0) {
-        return cv::Mat();
-    }
-    double scale = std::min(static_cast<double>(max_w) / plot.cols,
-                            static_cast<double>(max_h) / plot.rows);
-    scale = std::clamp(scale, 0.1, 1.0);
-    const int w = std::max(2, static_cast<int>(std::lround(plot.cols * scale)));
-    const int h = std::max(2, static_cast<int>(std::lround(plot.rows * scale)));
-    cv::Mat resized;
-    cv::resize(plot, resized, cv::Size(w, h), 0, 0, cv::INTER_AREA);
-    return resized;
-}
-
-void blit_plot(cv::Mat& frame, const cv::Mat& plot, const cv::Point& origin, const char* label) {
-    if (frame.empty() || plot.empty()) {
-        return;
-    }
-    const int x = std::clamp(origin.x, 0, frame.cols - 1);
-    const int y = std::clamp(origin.y, 0, frame.rows - 1);
-    const int w = std::min(plot.cols, frame.cols - x);
-    const int h = std::min(plot.rows, frame.rows - y);
-    if (w < 2 || h < 2) {
-        return;
-    }
-    cv::Rect roi(x, y, w, h);
-    plot(cv::Rect(0, 0, w, h)).copyTo(frame(roi));
-    cv::rectangle(frame, roi, cv::Scalar(0, 255, 255), 1);
-    if (label) {
-        cv::putText(frame, label, cv::Point(x + 4, y + 16), cv::FONT_HERSHEY_SIMPLEX,
-                    0.5, cv::Scalar(0, 255, 255), 1, cv::LINE_AA);
-    }
-}
-} // namespace
-
 int main() {
     spdlog::set_pattern("[%H:%M:%S.%e] [%^%l%$] %v");
     spdlog::set_level(spdlog::level::info);
@@ -88,204 +38,240 @@ int main() {
         return -1;
     }
     const auto config = *config_res;
+    logging::init({config.logging.queue_size, config.logging.ring_size, config.logging.dump_path});
+    logging::install_crash_handlers();
+    HBM_THREAD_NAME("main");
     spdlog::info("Config loaded in {:.1f} ms", std::chrono::duration<double, std::milli>(
         std::chrono::steady_clock::now() - app_start).count());
-    spdlog::info("Camera fps={}, acquisition_fps={}, window_duration_seconds={}",
+    spdlog::info("{} camera(s), default fps={}, acquisition_fps={}, window_duration_seconds={}", config.cameras.size(),
         config.camera.fps, config.camera.acquisition_fps, config.analysis.window_duration_seconds);
+    if (config.memory.pooled_mats) {
+        // Before the first Mat is created, so every buffer is recycled through the pool
+        mat_pool::install(config.memory.mat_pool_max_bytes);
+        spdlog::info("Pooled Mat allocator installed ({} MiB cache)", config.memory.mat_pool_max_bytes >> 20);
+    }
 
+    std::shared_ptr<TraceRecorder> trace;
+    if (config.tracing.enabled) {
+        trace = std::make_shared<TraceRecorder>(config.tracing.capacity);
+    }
+    const auto dump_trace = [&]() {
+        auto written = trace->write_chrome_json(config.tracing.dump_path);
+        if (written) {
+            spdlog::info("Wrote {} trace events to {}", *written, config.tracing.dump_path);
+        } else {
+            spdlog::warn("Trace dump failed: {}", written.error());
+        }
+    };
+
+    int exit_code = 0;
     try {
-        auto cam_start = std::chrono::steady_clock::now();
-        cv::VideoCapture cap(0);
-        if (!cap.isOpened()) {
-            std::println(stderr, "Error: Could not open camera.");
-            return -1;
+        // Declared inside the try so its final drain runs before logging::shutdown()
+        instr::Collector instrumentation;
+        auto stage_histograms = std::make_shared<instr::StageHistograms>();
+        instrumentation.add_backend(stage_histograms);
+        instrumentation.add_backend(std::make_shared<instr::LogBackend>(stage_histograms));
+
+        std::unique_ptr<MetricsServer> metrics;
+        if (config.metrics.enabled) {
+            auto server = MetricsServer::start({config.metrics.bind_address,
+                static_cast<uint16_t>(config.metrics.port), config.metrics.unix_socket}, stage_histograms);
+            if (server) {
+                metrics = std::move(*server);
+                spdlog::info("Metrics served at {}", config.metrics.unix_socket.empty()
+                    ? std::format("http://{}:{}/metrics", config.metrics.bind_address, config.metrics.port)
+                    : config.metrics.unix_socket);
+            } else {
+                spdlog::warn("Metrics endpoint disabled: {}", server.error());
+            }
+        }
+        if (trace) {
+            instrumentation.add_backend(trace);
         }
-        cap.set(cv::CAP_PROP_FPS, config.camera.fps);
-        spdlog::info("Camera opened in {:.1f} ms", std::chrono::duration<double, std::milli>(
-            std::chrono::steady_clock::now() - cam_start).count());
-        spdlog::info("Camera props: {}x{} @ {:.1f} fps",
-            cap.get(cv::CAP_PROP_FRAME_WIDTH),
-            cap.get(cv::CAP_PROP_FRAME_HEIGHT),
-            cap.get(cv::CAP_PROP_FPS));
 
         auto model_start = std::chrono::steady_clock::now();
-        FaceProcessor processor(MODEL_PATH);
+        const auto model = std::make_shared<const FaceModel>(MODEL_PATH); // Shared by every camera
         spdlog::info("Dlib model loaded in {:.1f} ms", std::chrono::duration<double, std::milli>(
             std::chrono::steady_clock::now() - model_start).count());
-        const double window_seconds = std::max(1.0, config.analysis.window_duration_seconds);
-        const int window_size = std::max(
-            2, static_cast<int>(std::lround(window_seconds * config.camera.acquisition_fps)));
-        HeartbeatAnalyzer analyzer(window_size, config.camera.acquisition_fps);
-        spdlog::info("Analysis window: {} samples (~{:.2f}s)", window_size,
-            window_size / config.camera.acquisition_fps);
+
+        WorkStealingPool scheduler(WorkStealingPool::Options{
+            .threads = config.scheduler.threads,
+            .pin_workers = config.scheduler.pin_workers,
+            .first_core = config.scheduler.first_core,
+            .spin = std::chrono::microseconds(config.scheduler.spin_us),
+            .name = "sched"});
+        spdlog::info("Scheduler: {} workers{}{}", scheduler.size(), config.scheduler.pin_workers ? ", pinned" : "",
+            config.scheduler.parallel_detection ? ", parallel detection" : "");
+
+        // The primary camera must open; the others are skipped with a warning
+        std::vector<std::unique_ptr<CameraPipeline>> cameras;
+        for (size_t i = 0; i < config.cameras.size(); ++i) {
+            try {
+                cameras.push_back(std::make_unique<CameraPipeline>(i, config.cameras[i], config, model, scheduler));
+            } catch (const std::exception& e) {
+                if (i == 0) {
+                    throw; // Through the shared cleanup below, so queued log records and the trace are written
+                }
+                spdlog::warn("{}; continuing without it", e.what());
+            }
+        }
+        CameraPipeline& primary = *cameras.front();
 
         auto hud_start = std::chrono::steady_clock::now();
         Overlay hud(config); // Pass config to HUD
         spdlog::info("HUD created in {:.1f} ms", std::chrono::duration<double, std::milli>(
             std::chrono::steady_clock::now() - hud_start).count());
 
+        hud.on_dump_log_hotkey([]() {
+            const size_t n = logging::dump_recent();
+            spdlog::info("Dumped {} log records", n);
+        });
+        if (trace) {
+            hud.on_dump_trace_hotkey(dump_trace);
+        }
         std::jthread hud_thread([&hud]() { hud.run(); });
         spdlog::info("HUD thread started");
 
-        cv::Mat frame;
-        const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
-            std::chrono::duration<double>(1.0 / config.camera.acquisition_fps));
-        auto last_buffer_log = std::chrono::steady_clock::now();
-        auto last_stats_log = std::chrono::steady_clock::now();
-        RunningStats sample_dt_stats;
-        bool has_last_sample = false;
-        std::chrono::steady_clock::time_point last_sample_time;
-        size_t frame_count = 0;
-        size_t face_found_count = 0;
-        bool buffer_ready_logged = false;
-        bool last_debug_mode = false;
-        while (true) {
-            auto frame_start = std::chrono::steady_clock::now();
-            if (!cap.read(frame)) {
-                break;
-            }
-            auto read_end = std::chrono::steady_clock::now();
-            ++frame_count;
+        DebugVisualizer debug_viz(cv::Size(config.hud.width, config.hud.height), config.hud.debug_fps,
+            [&hud](const cv::Mat& layer) { hud.update_debug_layer(layer); });
 
-            bool debug_mode = hud.is_debug_mode();
-            if (debug_mode != last_debug_mode) {
-                spdlog::info("Debug mode {}", debug_mode ? "ON" : "OFF");
-                spdlog::set_level(debug_mode ? spdlog::level::debug : spdlog::level::info);
-                last_debug_mode = debug_mode;
+        std::optional<SharedHudWriter> shared_hud;
+        if (config.shared_memory.enabled) {
+            auto writer = SharedHudWriter::create(config.shared_memory.name,
+                cv::Size(config.shared_memory.preview_width, config.shared_memory.preview_height));
+            if (writer) {
+                shared_hud.emplace(std::move(*writer));
+                spdlog::info("Shared HUD channel '{}' published", config.shared_memory.name);
+            } else {
+                spdlog::warn("Shared HUD channel disabled: {}", writer.error());
             }
-            
-            // Apply frame ROI if defined
-            cv::Mat processing_frame = frame;
-            if (config.camera.frame_roi.area() > 0) {
-                processing_frame = frame(config.camera.frame_roi & cv::Rect(0,0,frame.cols,frame.rows));
+        }
+
+        const double window_seconds = std::max(1.0, config.analysis.window_duration_seconds);
+        std::unique_ptr<SessionRecorder> recorder;
+        if (config.recording.enabled) {
+            const SessionHeader header{config.cameras[0].acquisition_fps, window_seconds, config.analysis.min_bpm,
+                config.analysis.max_bpm, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count()};
+            auto created = SessionRecorder::create(config.recording.path, header, {config.recording.chunk_frames});
+            if (created) {
+                recorder = std::move(*created);
+                spdlog::info("Recording session to {} (camera '{}')", config.recording.path, primary.name());
+            } else {
+                spdlog::warn("Session recording disabled: {}", created.error());
             }
+        }
+        const auto session_start = std::chrono::steady_clock::now();
 
-            FaceTimings face_timings;
-            auto face_start = std::chrono::steady_clock::now();
-            auto face_res = processor.get_central_face(processing_frame, debug_mode ? &face_timings : nullptr);
-            auto face_end = std::chrono::steady_clock::now();
-            auto forehead_end = face_end;
-            auto sample_end = face_end;
-            auto bpm_end = face_end;
-            auto plots_end = face_end;
-            auto overlay_end = face_end;
-            if (face_res) {
-                ++face_found_count;
-                cv::Mat forehead;
-                if (debug_mode) {
-                    cv::Mat forehead_rect;
-                    forehead = processor.get_stabilized_forehead(processing_frame, *face_res, &forehead_rect);
-                    processor.draw_debug(processing_frame, *face_res, forehead_rect);
-                }
-                else {
-                    forehead = processor.get_stabilized_forehead(processing_frame, *face_res);
-                }
-                forehead_end = std::chrono::steady_clock::now();
-                analyzer.add_sample(processor.get_avg_bgr(forehead));
-                if (debug_mode) {
-                    auto now = std::chrono::steady_clock::now();
-                    if (has_last_sample) {
-                        const double dt_ms = std::chrono::duration<double, std::milli>(now - last_sample_time).count();
-                        sample_dt_stats.add(dt_ms);
+        // Preview, debug view, recording and shared memory follow the primary camera only
+        primary.on_capture([&](const cv::Mat& frame) {
+            hud.update_frame(frame);
+            if (shared_hud) {
+                shared_hud->publish_preview(frame);
+            }
+        });
+        primary.on_result([&](const CameraPipeline::FrameResult& r) {
+            if (recorder) {
+                SessionFrame record;
+                record.t_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(r.start - session_start).count();
+                record.stage_us = r.stage_us;
+                if (r.face) {
+                    const dlib::rectangle box = r.face->get_rect();
+                    record.face = true;
+                    record.bgr = {r.avg_bgr[0], r.avg_bgr[1], r.avg_bgr[2]};
+                    record.box = {static_cast<int32_t>(box.left()), static_cast<int32_t>(box.top()),
+                                  static_cast<int32_t>(box.width()), static_cast<int32_t>(box.height())};
+                    int k = 0;
+                    for (const unsigned long part : {19ul, 24ul, 27ul}) {
+                        record.anchors[k++] = static_cast<int32_t>(r.face->part(part).x());
+                        record.anchors[k++] = static_cast<int32_t>(r.face->part(part).y());
+                    }
+                    if (r.bpm) {
+                        record.bpm = *r.bpm;
+                        record.confidence = r.analyzer.confidence();
                     }
-                    last_sample_time = now;
-                    has_last_sample = true;
                 }
-                sample_end = std::chrono::steady_clock::now();
-                auto bpm = analyzer.calculate_bpm(config.analysis.min_bpm, config.analysis.max_bpm, debug_mode);
-                bpm_end = std::chrono::steady_clock::now();
-                if (bpm) {
-                    hud.update_bpm(*bpm);
+                recorder->append(record);
+            }
+            // Debug drawing happens on the visualizer thread; here we only snapshot state
+            if (r.debug) {
+                debug_viz.submit(r.frame.size(), r.analyzer, r.face ? &*r.face : nullptr,
+                                 r.forehead_corners.empty() ? nullptr : &r.forehead_corners);
+            } else {
+                debug_viz.disable();
+            }
+            if (r.bpm) {
+                hud.update_bpm(*r.bpm, 0);
+                if (shared_hud) {
+                    shared_hud->publish_bpm(*r.bpm, r.analyzer.confidence());
                 }
             }
+        });
+        for (size_t i = 1; i < cameras.size(); ++i) {
+            cameras[i]->on_result([&hud, index = cameras[i]->index()](const CameraPipeline::FrameResult& r) {
+                if (r.bpm) {
+                    hud.update_bpm(*r.bpm, index);
+                }
+            });
+        }
 
-            if (debug_mode && analyzer.has_debug_plots()) {
-                const int margin = 10;
-                const int max_w = std::min(360, std::max(160, processing_frame.cols / 2));
-                const int max_h = std::min(180, std::max(120, (processing_frame.rows - 3 * margin) / 2));
-                cv::Mat plot_input = resize_plot_to_fit(analyzer.debug_fft_input(), max_w, max_h);
-                cv::Mat plot_fft = resize_plot_to_fit(analyzer.debug_fft_magnitude(), max_w, max_h);
-
-                int x = processing_frame.cols - plot_input.cols - margin;
-                int y = margin;
-                blit_plot(processing_frame, plot_input, cv::Point(x, y), "FFT Input");
+        std::vector<std::jthread> camera_threads;
+        for (auto& camera : cameras) {
+            camera_threads.emplace_back([&camera](std::stop_token st) { camera->run(st); });
+        }
+        spdlog::info("{} camera pipeline(s) running", cameras.size());
 
-                y += plot_input.rows + margin;
-                if (!plot_fft.empty()) {
-                    x = processing_frame.cols - plot_fft.cols - margin;
-                    blit_plot(processing_frame, plot_fft, cv::Point(x, y), "FFT Mag");
+        // The main thread only follows the debug toggle and logs process-wide stats
+        auto last_stats_log = std::chrono::steady_clock::now();
+        bool last_debug_mode = false;
+        while (!primary.finished()) {
+            const bool debug_mode = hud.is_debug_mode();
+            if (debug_mode != last_debug_mode) {
+                spdlog::info("Debug mode {}", debug_mode ? "ON" : "OFF");
+                spdlog::set_level(debug_mode ? spdlog::level::debug : spdlog::level::info);
+                for (auto& camera : cameras) {
+                    camera->set_debug(debug_mode);
                 }
-                plots_end = std::chrono::steady_clock::now();
+                last_debug_mode = debug_mode;
             }
-
-            hud.update_frame(processing_frame);
-            overlay_end = std::chrono::steady_clock::now();
             if (cv::waitKey(1) == 27) {
                 break;
             }
-
-            auto elapsed = std::chrono::steady_clock::now() - frame_start;
-            if (debug_mode) {
-                const auto ms = [](auto d) { return std::chrono::duration<double, std::milli>(d).count(); };
-                spdlog::debug("Timing ms: read {:.2f}, face {:.2f} (detect {:.2f}, select {:.2f}, predict {:.2f}), forehead {:.2f}, sample {:.2f}, bpm {:.2f}, plots {:.2f}, overlay {:.2f}, total {:.2f}",
-                    ms(read_end - frame_start),
-                    ms(face_end - face_start),
-                    face_timings.detect_ms,
-                    face_timings.select_ms,
-                    face_timings.predict_ms,
-                    ms(forehead_end - face_end),
-                    ms(sample_end - forehead_end),
-                    ms(bpm_end - sample_end),
-                    ms(plots_end - bpm_end),
-                    ms(overlay_end - plots_end),
-                    ms(elapsed));
-                auto now = std::chrono::steady_clock::now();
-                if (now - last_stats_log > std::chrono::seconds(2) && sample_dt_stats.count > 1) {
-                    const double target_dt_ms = 1000.0 / config.camera.acquisition_fps;
-                    const double std_ms = std::sqrt(sample_dt_stats.variance());
-                    const double est_fps = 1000.0 / sample_dt_stats.mean;
-                    const double max_jitter = sample_dt_stats.max - target_dt_ms;
-                    const double min_jitter = sample_dt_stats.min - target_dt_ms;
-                    const double face_ratio = frame_count > 0
-                        ? (100.0 * static_cast<double>(face_found_count) / static_cast<double>(frame_count))
-                        : 0.0;
-                    spdlog::debug("Sample dt: mean {:.2f} ms (std {:.2f}), min {:.2f}, max {:.2f}, est {:.2f} fps, jitter [min {:.2f}, max {:.2f}] ms, faces {:.0f}% ({}/{})",
-                        sample_dt_stats.mean, std_ms, sample_dt_stats.min, sample_dt_stats.max,
-                        est_fps, min_jitter, max_jitter, face_ratio, face_found_count, frame_count);
-                    last_stats_log = now;
-                    sample_dt_stats = RunningStats{};
-                    frame_count = 0;
-                    face_found_count = 0;
-                }
-            }
-            if (elapsed > interval * 2) {
-                spdlog::warn("Frame processing overrun: {:.1f} ms (interval {:.1f} ms)",
-                    std::chrono::duration<double, std::milli>(elapsed).count(),
-                    std::chrono::duration<double, std::milli>(interval).count());
-            } else if (spdlog::should_log(spdlog::level::debug)) {
-                spdlog::debug("Frame processing time: {:.1f} ms",
-                    std::chrono::duration<double, std::milli>(elapsed).count());
-            }
-            if (!buffer_ready_logged && analyzer.buffer_size() >= analyzer.window_size()) {
-                spdlog::info("Buffer filled: {} samples", analyzer.window_size());
-                buffer_ready_logged = true;
-            } else if (!buffer_ready_logged) {
-                auto now = std::chrono::steady_clock::now();
-                if (now - last_buffer_log > std::chrono::seconds(2)) {
-                    const double pct = 100.0 * analyzer.buffer_size() /
-                        std::max<size_t>(1, analyzer.window_size());
-                    spdlog::info("Buffering: {}/{} ({:.0f}%)",
-                        analyzer.buffer_size(), analyzer.window_size(), pct);
-                    last_buffer_log = now;
+            const auto now = std::chrono::steady_clock::now();
+            if (debug_mode && now - last_stats_log > std::chrono::seconds(2)) {
+                const auto paint = hud.paint_stats();
+                spdlog::debug("HUD paint: {} requested, {} performed, avg {:.1f} us",
+                    paint.requested, paint.paints, paint.avg_paint_us);
+                if (const PooledMatAllocator* pool = mat_pool::installed()) {
+                    const auto ps = pool->stats();
+                    spdlog::debug("Mat pool: {} hits, {} misses, {} evictions, {:.1f} MiB in use, {:.1f} MiB cached",
+                        ps.hits, ps.misses, ps.evictions, ps.bytes_in_use / 1048576.0, ps.bytes_cached / 1048576.0);
                 }
+                const auto ss = scheduler.stats();
+                spdlog::debug("Scheduler: {} tasks, {} stolen, {} parks", ss.executed, ss.stolen, ss.parks);
+                last_stats_log = now;
             }
-            if (elapsed < interval) {
-                std::this_thread::sleep_for(interval - elapsed);
-            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
         }
+        camera_threads.clear(); // Requests stop and joins; hooks stop touching the HUD and recorder
         hud.stop();
+        if (recorder) {
+            const uint64_t dropped = recorder->frames_dropped();
+            recorder.reset(); // Writes the partial chunk and joins the writer
+            std::error_code ec;
+            spdlog::info("Session recorded to {} ({} KiB, {} frames dropped)", config.recording.path,
+                std::filesystem::file_size(config.recording.path, ec) / 1024, dropped);
+        }
     } catch (const std::exception& e) {
+        spdlog::critical("Fatal: {}", e.what());
         std::println(stderr, "Fatal: {}", e.what());
+        logging::dump_recent();
+        exit_code = -1;
+    }
+    // The collector has been destroyed by now, so every recorded zone is in the trace
+    if (trace && config.tracing.dump_on_exit) {
+        dump_trace();
     }
-    return 0;
+    logging::shutdown();
+    return exit_code;
 }
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <expected>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FaceProcessor.hpp"
+#include "WorkStealingPool.hpp"
+#include "bench_common.hpp" // Same inputs as the benchmarks: $HBM_BENCH_IMAGES, benchmarks/data or synthetic
+
+namespace {
+using FaceResult = std::expected<dlib::full_object_detection, std::string>;
+
+bool same_landmarks(const FaceResult& a, const FaceResult& b) {
+    if (a.has_value() != b.has_value()) {
+        return false;
+    }
+    if (!a) {
+        return true;
+    }
+    if (a->get_rect() != b->get_rect() || a->num_parts() != b->num_parts()) {
+        return false;
+    }
+    for (unsigned long i = 0; i < a->num_parts(); ++i) {
+        if (a->part(i) != b->part(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<cv::Mat> all_frames() {
+    std::vector<cv::Mat> frames;
+    for (const auto& size : bench::resolutions()) {
+        for (auto& f : bench::frames(size)) {
+            frames.push_back(std::move(f));
+        }
+    }
+    return frames;
+}
+} // namespace
+
+// Every hardware thread runs its own FaceProcessor over the one shared model, in a different
+// frame order, and must reproduce the single-threaded landmarks exactly.
+TEST(FaceModel, SharedAcrossThreadsMatchesSingleThreaded) {
+    const std::vector<cv::Mat> frames = all_frames();
+    std::vector<FaceResult> reference;
+    {
+        FaceProcessor single(bench::model());
+        for (const auto& f : frames) {
+            reference.push_back(single.get_central_face(f));
+        }
+    }
+
+    const unsigned threads = std::max(2u, std::min(std::thread::hardware_concurrency(), 16u));
+    constexpr size_t kRounds = 3;
+    std::atomic<size_t> mismatches{0};
+    {
+        std::vector<std::jthread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                FaceProcessor processor(bench::model());
+                for (size_t k = 0; k < frames.size() * kRounds; ++k) {
+                    const size_t i = (k + t) % frames.size();
+                    if (!same_landmarks(processor.get_central_face(frames[i]), reference[i])) {
+                        ++mismatches;
+                    }
+                }
+            });
+        }
+    }
+    EXPECT_EQ(mismatches.load(), 0u) << "out of " << threads * frames.size() * kRounds << " results on "
+                                     << threads << " threads";
+}
+
+// One scheduler task per HOG filter, merged by non-maximum suppression, must find the same face as
+// the serial scan, whatever the worker count
+TEST(FaceProcessor, ParallelDetectionMatchesSerial) {
+    const std::vector<cv::Mat> frames = all_frames();
+    FaceProcessor serial(bench::model());
+    for (const unsigned workers : {1u, 2u, 5u}) {
+        WorkStealingPool pool(workers);
+        FaceProcessor parallel(bench::model());
+        parallel.set_scheduler(&pool);
+        for (size_t i = 0; i < frames.size(); ++i) {
+            EXPECT_TRUE(same_landmarks(parallel.get_central_face(frames[i]), serial.get_central_face(frames[i])))
+                << "frame " << i << " (" << frames[i].cols << "x" << frames[i].rows << "), " << workers << " workers";
+        }
+    }
+}
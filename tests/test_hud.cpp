@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "HudCompositor.hpp"
+
+namespace {
+cv::Mat random_bgra(cv::Size size, uint64_t seed) {
+    cv::Mat bgra(size, CV_8UC4);
+    cv::theRNG().state = seed;
+    cv::randu(bgra, cv::Scalar::all(0), cv::Scalar::all(256));
+    return bgra;
+}
+
+// Random bytes are not valid premultiplied pixels (colour may exceed alpha), which also
+// exercises the saturating add that every path must share.
+cv::Mat random_premultiplied(cv::Size size, uint64_t seed) {
+    cv::Mat bgra = random_bgra(size, seed);
+    for (int y = 0; y < bgra.rows; ++y) {
+        auto* p = bgra.ptr<uint8_t>(y);
+        for (int x = 0; x < bgra.cols; ++x, p += 4) {
+            if (x % 5 == 0) {
+                p[3] = 0; // Fully transparent and fully opaque pixels are the common cases
+            } else if (x % 5 == 1) {
+                p[3] = 255;
+            }
+        }
+    }
+    return bgra;
+}
+
+bool identical(const cv::Mat& a, const cv::Mat& b) {
+    return a.size() == b.size() && a.type() == b.type() && cv::countNonZero(a.reshape(1) != b.reshape(1)) == 0;
+}
+
+// A view of `rows` x `cols` BGRA pixels starting `offset` bytes into `storage`, so the SIMD
+// loads see every alignment, not just the 16-byte one OpenCV allocates
+cv::Mat unaligned_view(std::vector<uint8_t>& storage, int rows, int cols, size_t offset, const cv::Mat& contents) {
+    const size_t step = static_cast<size_t>(cols) * 4 + 3; // Rows start at varying alignments too
+    storage.assign(offset + step * static_cast<size_t>(rows), 0);
+    cv::Mat view(rows, cols, CV_8UC4, storage.data() + offset, step);
+    contents.copyTo(view);
+    return view;
+}
+
+// Three 4x3 cells: 'A' fully covered, 'B' half covered (left columns), ' ' empty
+GlyphAtlas test_atlas() {
+    cv::Mat a(3, 4, CV_8UC1, cv::Scalar(255));
+    cv::Mat b = cv::Mat::zeros(3, 2, CV_8UC1);
+    b.col(0).setTo(255);
+    cv::Mat space = cv::Mat::zeros(3, 2, CV_8UC1);
+    return GlyphAtlas::pack({{'A', a}, {'B', b}, {' ', space}});
+}
+
+const cv::Vec4b kWhite(255, 255, 255, 255);
+const cv::Vec4b kBlack(0, 0, 0, 255);
+const cv::Vec4b kBackground(50, 100, 150, 255);
+} // namespace
+
+TEST(BlendPremultiplied, MatchesScalarAtOddWidthsAndUnalignedStarts) {
+    // Widths around the SSE2 (4 px) and NEON (8 px) steps
+    const int widths[] = {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 641};
+    uint64_t seed = 1;
+    for (const int width : widths) {
+        for (size_t offset = 0; offset < 16; ++offset) {
+            const cv::Mat src = random_premultiplied({width, 3}, seed++);
+            const cv::Mat dst = random_bgra({width, 3}, seed++);
+
+            cv::Mat expected = dst.clone();
+            hud::blend_premultiplied_scalar(src, expected);
+
+            std::vector<uint8_t> src_storage, dst_storage;
+            const cv::Mat src_view = unaligned_view(src_storage, src.rows, src.cols, (offset * 7) % 16, src);
+            cv::Mat dst_view = unaligned_view(dst_storage, dst.rows, dst.cols, offset, dst);
+            hud::blend_premultiplied(src_view, dst_view);
+            ASSERT_TRUE(identical(dst_view, expected)) << "width " << width << ", offset " << offset;
+        }
+    }
+}
+
+TEST(BlendPremultiplied, TransparentKeepsDestinationAndOpaqueReplacesIt) {
+    const cv::Mat dst = random_bgra({37, 2}, 5);
+    cv::Mat out = dst.clone();
+    hud::blend_premultiplied(cv::Mat::zeros(dst.size(), CV_8UC4), out);
+    EXPECT_TRUE(identical(out, dst));
+
+    cv::Mat opaque = random_bgra(dst.size(), 6);
+    opaque.reshape(1, static_cast<int>(opaque.total())).col(3).setTo(255);
+    out = dst.clone();
+    hud::blend_premultiplied(opaque, out);
+    EXPECT_TRUE(identical(out, opaque));
+}
+
+TEST(BlendPremultipliedAt, ClipsToTheTarget) {
+    const cv::Mat dst = random_bgra({9, 7}, 11);
+    const cv::Mat src = random_premultiplied({5, 4}, 12);
+    const cv::Point origins[] = {{0, 0}, {2, 1}, {-2, -1}, {6, 5}, {-3, 4}, {7, -2}, {-5, 0}, {9, 0}, {0, 7}, {-1, -1}};
+    for (const cv::Point origin : origins) {
+        cv::Mat expected = dst.clone();
+        const cv::Rect dst_rect = cv::Rect(origin, src.size()) & cv::Rect(0, 0, dst.cols, dst.rows);
+        if (!dst_rect.empty()) {
+            cv::Mat roi = expected(dst_rect);
+            hud::blend_premultiplied_scalar(src(cv::Rect(dst_rect.tl() - origin, dst_rect.size())), roi);
+        }
+
+        cv::Mat out = dst.clone();
+        hud::blend_premultiplied_at(src, out, origin);
+        EXPECT_TRUE(identical(out, expected)) << "origin " << origin;
+    }
+}
+
+TEST(BlendPremultipliedAt, IgnoresEmptyImages) {
+    const cv::Mat dst = random_bgra({4, 4}, 21);
+    cv::Mat out = dst.clone();
+    hud::blend_premultiplied_at(cv::Mat(), out, {0, 0});
+    EXPECT_TRUE(identical(out, dst));
+
+    cv::Mat empty;
+    hud::blend_premultiplied_at(random_premultiplied({2, 2}, 22), empty, {0, 0});
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(GlyphAtlas, PackKeepsAdvancesAndLineHeight) {
+    const GlyphAtlas atlas = test_atlas();
+    EXPECT_EQ(atlas.line_height, 3);
+    EXPECT_EQ(atlas.glyphs['A'].advance, 4);
+    EXPECT_EQ(atlas.glyphs['B'].advance, 2);
+    EXPECT_EQ(atlas.glyphs[' '].advance, 2);
+    EXPECT_TRUE(atlas.glyphs['C'].cell.empty());
+    EXPECT_EQ(atlas.coverage.size(), cv::Size(8, 3));
+}
+
+TEST(HudCompositor, MeasureCoversShadowAndLines) {
+    const HudCompositor hud(test_atlas(), cv::Scalar(255, 255, 255));
+    EXPECT_EQ(hud.measure("A"), cv::Size(4 + 2, 3 + 2));
+    EXPECT_EQ(hud.measure("AB A"), cv::Size(4 + 2 + 2 + 4 + 2, 3 + 2));
+    EXPECT_EQ(hud.measure("AC\xC3"), cv::Size(4 + 2, 3 + 2)); // Missing and non-ASCII characters take no room
+    EXPECT_EQ(hud.measure("A\nAB"), cv::Size(6 + 2, 2 * 3 + 2));
+    EXPECT_EQ(hud.measure("AB\nA\n"), cv::Size(6 + 2, 3 * 3 + 2));
+    EXPECT_EQ(hud.measure(""), cv::Size(2, 3 + 2));
+}
+
+TEST(HudCompositor, DrawTextPlacesGlyphsShadowsAndLines) {
+    const HudCompositor hud(test_atlas(), cv::Scalar(255, 255, 255));
+    cv::Mat target(20, 20, CV_8UC4, kBackground);
+    const cv::Point origin(3, 2);
+    hud.draw_text(target, origin, "A\nBA");
+
+    // Line 1: 'A' at the origin, its shadow showing below and right of it
+    EXPECT_EQ(target.at<cv::Vec4b>(origin), kWhite);
+    EXPECT_EQ(target.at<cv::Vec4b>(origin + cv::Point(3, 2)), kWhite);
+    EXPECT_EQ(target.at<cv::Vec4b>(origin + cv::Point(5, 2)), kBlack);
+    // Line 2 restarts at origin.x one line_height down: 'B' covers its first column only
+    const cv::Point line2 = origin + cv::Point(0, 3);
+    EXPECT_EQ(target.at<cv::Vec4b>(line2 + cv::Point(0, 1)), kWhite);
+    EXPECT_EQ(target.at<cv::Vec4b>(line2 + cv::Point(1, 0)), kBackground);
+    EXPECT_EQ(target.at<cv::Vec4b>(line2 + cv::Point(2, 0)), kWhite); // 'A' after B's advance
+    EXPECT_EQ(target.at<cv::Vec4b>(line2 + cv::Point(5, 2)), kWhite);
+
+    // Nothing is drawn outside the measured box
+    const cv::Rect box(origin, hud.measure("A\nBA"));
+    for (int y = 0; y < target.rows; ++y) {
+        for (int x = 0; x < target.cols; ++x) {
+            if (!box.contains({x, y})) {
+                ASSERT_EQ(target.at<cv::Vec4b>(y, x), kBackground) << "at " << x << "," << y;
+            }
+        }
+    }
+}
+
+TEST(HudCompositor, DrawTextClipsAtTheTargetEdges) {
+    const HudCompositor hud(test_atlas(), cv::Scalar(255, 255, 255));
+    cv::Mat target(4, 5, CV_8UC4, kBackground);
+    hud.draw_text(target, {-2, 2}, "AA\nA");
+    EXPECT_EQ(target.at<cv::Vec4b>(2, 0), kWhite);
+    EXPECT_EQ(target.at<cv::Vec4b>(3, 4), kWhite);
+    EXPECT_EQ(target.at<cv::Vec4b>(0, 0), kBackground);
+}
+
+TEST(GlyphAtlas, HudCharsetCoversPrintableAscii) {
+    ASSERT_EQ(GlyphAtlas::kHudCharset.size(), 0x7Fu - 0x20u);
+    for (char ch = 0x20; ch < 0x7F; ++ch) {
+        EXPECT_NE(GlyphAtlas::kHudCharset.find(ch), std::string_view::npos) << "missing '" << ch << "'";
+    }
+}
+
+// Camera lines show config names, so every character of a name must take room and leave ink
+TEST(HudCompositor, CameraLinesKeepEveryCharacter) {
+    const GlyphAtlas atlas = GlyphAtlas::rasterize_hershey(GlyphAtlas::kHudCharset, 16);
+    const HudCompositor hud(atlas, cv::Scalar(255, 255, 255));
+    for (const std::string line : {"cam0: 72.5", "desk: ...", "clip: 101.3", "Side-2 (IR): 64.0"}) {
+        int advances = 0;
+        for (const char ch : line) {
+            const auto& glyph = atlas.glyphs[static_cast<unsigned char>(ch)];
+            ASSERT_FALSE(glyph.cell.empty()) << "'" << ch << "' of \"" << line << "\"";
+            ASSERT_GT(glyph.advance, 0) << "'" << ch << "' of \"" << line << "\"";
+            advances += glyph.advance;
+        }
+        EXPECT_EQ(hud.measure(line), cv::Size(advances + 2, atlas.line_height + 2)) << line;
+
+        // Each visible character leaves white text ink in its own cell. Shadows only darken the
+        // background, so a neighbour's shadow cannot stand in for a dropped character.
+        cv::Mat target(atlas.line_height + 2, advances + 2, CV_8UC4, kBackground);
+        hud.draw_text(target, {0, 0}, line);
+        int x = 0;
+        for (const char ch : line) {
+            const int advance = atlas.glyphs[static_cast<unsigned char>(ch)].advance;
+            if (ch != ' ') {
+                cv::Mat blue;
+                cv::extractChannel(target(cv::Rect(x, 0, advance, atlas.line_height)), blue, 0);
+                double brightest = 0.0;
+                cv::minMaxLoc(blue, nullptr, &brightest);
+                EXPECT_GT(brightest, kBackground[0]) << "'" << ch << "' of \"" << line << "\" left no ink";
+            }
+            x += advance;
+        }
+    }
+}
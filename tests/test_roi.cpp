@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include "RoiStats.hpp"
+
+namespace {
+constexpr roi_stats::Isa kIsas[] = {roi_stats::Isa::Scalar, roi_stats::Isa::Sse42, roi_stats::Isa::Avx2,
+                                    roi_stats::Isa::Avx512, roi_stats::Isa::Neon};
+
+bool same(const roi_stats::Accum& a, const roi_stats::Accum& b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+roi_stats::Accum run(roi_stats::RowKernel k, const uint8_t* bgr, const uint8_t* mask, size_t n) {
+    roi_stats::Accum acc;
+    k(bgr, mask, n, 5, 250, acc);
+    return acc;
+}
+} // namespace
+
+// Every kernel available on this CPU against the scalar reference: odd lengths around each vector
+// width, unaligned starts, with and without a mask, and runs long enough to hit the 32-bit square flush
+TEST(RoiStats, KernelsMatchScalar) {
+    const roi_stats::RowKernel reference = roi_stats::kernel(roi_stats::Isa::Scalar);
+    ASSERT_NE(reference, nullptr);
+    const size_t lengths[] = {0, 1, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 2700, 4096 * 64 + 13, 1920 * 1080 * 2};
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (const size_t n : lengths) {
+        for (size_t offset = 0; offset < 3; ++offset) {
+            std::vector<uint8_t> bgr(n * 3 + offset);
+            std::vector<uint8_t> mask(n + offset);
+            for (auto& b : bgr) {
+                b = static_cast<uint8_t>(byte(rng));
+            }
+            for (auto& m : mask) {
+                m = byte(rng) % 3 ? static_cast<uint8_t>(byte(rng) | 1) : 0;
+            }
+            const uint8_t* masked = mask.data() + offset;
+            for (const uint8_t* m : {static_cast<const uint8_t*>(nullptr), masked}) {
+                const roi_stats::Accum expected = run(reference, bgr.data() + offset, m, n);
+                for (const roi_stats::Isa isa : kIsas) {
+                    if (const roi_stats::RowKernel k = roi_stats::kernel(isa)) {
+                        ASSERT_TRUE(same(run(k, bgr.data() + offset, m, n), expected))
+                            << roi_stats::isa_name(isa) << " at n=" << n << ", offset " << offset
+                            << (m ? " (masked)" : "");
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(RoiStats, MeanMatchesOpenCv) {
+    cv::Mat bgr(45, 61, CV_8UC3);
+    cv::theRNG().state = 3;
+    cv::randu(bgr, cv::Scalar::all(0), cv::Scalar::all(256));
+    cv::Mat mask = cv::Mat::zeros(bgr.size(), CV_8UC1);
+    cv::circle(mask, {30, 22}, 18, cv::Scalar(255), cv::FILLED);
+
+    EXPECT_EQ(roi_stats::mean(roi_stats::compute(bgr)), cv::mean(bgr));
+    EXPECT_EQ(roi_stats::mean(roi_stats::compute(bgr, mask)), cv::mean(bgr, mask));
+    // A non-continuous view, as get_avg_bgr gets from a forehead crop
+    const cv::Mat crop = bgr(cv::Rect(3, 2, 40, 30));
+    EXPECT_EQ(roi_stats::mean(roi_stats::compute(crop)), cv::mean(crop));
+}
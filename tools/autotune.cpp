@@ -0,0 +1,379 @@
+/**
+ * @file autotune.cpp
+ * @brief Parallel parameter sweep of the analysis settings over a UBFC-rPPG style dataset.
+ *
+ * Usage: HeartbeatAutotune [options] dataset_root
+ *   --fps 10,15,30         acquisition_fps candidates (config clamps to 10..60)
+ *   --window 4,6,8.5,12    window_duration_seconds candidates
+ *   --min-bpm 40,45,50     analysis.min_bpm candidates
+ *   --max-bpm 150,180,200  analysis.max_bpm candidates
+ *   --random N             N random points inside the candidate ranges instead of the full grid
+ *   --seed S               random search seed (default 1)
+ *   --jobs N               worker threads (default: all cores)
+ *   --cache-dir DIR        where per-video sample traces are kept (default .hbm_traces)
+ *   --config FILE          base config for --write-profile (default config.yaml)
+ *   --write-profile FILE   write the base config with the most accurate Pareto point applied
+ *                          (the tuned rate also replaces any per-camera acquisition_fps)
+ *
+ * Face detection runs once per video at its native frame rate and the ROI averages are cached
+ * as CSV traces; every candidate then only replays HeartbeatAnalyzer over those shared, read-only
+ * traces. Candidates are scored on accuracy (MAE vs ground truth), latency (seconds of history per
+ * estimate) and CPU (analyzer busy time per second of input), and the Pareto front is printed.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/videoio.hpp>
+#include <spdlog/spdlog.h>
+#include <yaml-cpp/yaml.h>
+#include "Evaluation.hpp"
+#include "FaceProcessor.hpp"
+#include "HeartbeatAnalyzer.hpp"
+
+namespace {
+struct Params {
+    double fps{10.0};
+    double window_seconds{8.5};
+    double min_bpm{45.0};
+    double max_bpm{180.0};
+};
+
+struct Subject {
+    std::string name;
+    eval::GroundTruth truth;
+    eval::SampleTrace trace;
+};
+
+struct Score {
+    Params params;
+    eval::ErrorStats error;
+    double coverage{0.0};       // Share of acquisition ticks that produced an estimate
+    double latency_s{0.0};      // History behind each estimate (window samples / fps)
+    double cpu_ms_per_s{0.0};   // Analyzer busy time per second of input
+};
+
+std::vector<double> parse_list(const char* text) {
+    std::vector<double> out;
+    std::stringstream in(text);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        if (!item.empty()) {
+            out.push_back(std::atof(item.c_str()));
+        }
+    }
+    return out;
+}
+
+template <typename Fn>
+void parallel_for(size_t count, unsigned jobs, Fn&& fn) {
+    std::atomic<size_t> next{0};
+    std::vector<std::jthread> workers;
+    for (unsigned w = 0; w < std::min<size_t>(jobs, count); ++w) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < count; i = next++) {
+                fn(i);
+            }
+        });
+    }
+}
+
+// Same per-frame work as the live app, at the video's native rate so any lower fps can be replayed
+eval::SampleTrace extract_trace(const std::filesystem::path& video, FaceProcessor& processor) {
+    eval::SampleTrace trace;
+    cv::VideoCapture cap(video.string());
+    const double fps = cap.get(cv::CAP_PROP_FPS) > 0.0 ? cap.get(cv::CAP_PROP_FPS) : 30.0;
+    cv::Mat frame;
+    for (size_t i = 0; cap.read(frame); ++i) {
+        trace.time_s.push_back(static_cast<double>(i) / fps);
+        if (auto face = processor.get_central_face(frame)) {
+            const cv::Scalar avg = processor.get_avg_bgr(processor.get_stabilized_forehead(frame, *face));
+            trace.face.push_back(true);
+            trace.bgr.push_back({avg[0], avg[1], avg[2]});
+        } else {
+            trace.face.push_back(false);
+            trace.bgr.push_back({0.0, 0.0, 0.0});
+        }
+    }
+    return trace;
+}
+
+Score evaluate(const Params& p, const std::vector<Subject>& subjects) {
+    Score score{p};
+    const int window = std::max(2, static_cast<int>(std::lround(p.window_seconds * p.fps)));
+    score.latency_s = window / p.fps;
+    std::vector<double> estimate, reference;
+    size_t ticks = 0;
+    double input_seconds = 0.0;
+    std::chrono::steady_clock::duration busy{};
+    for (const auto& s : subjects) {
+        HeartbeatAnalyzer analyzer(window, p.fps);
+        const auto& tr = s.trace;
+        double next_tick = tr.time_s.empty() ? 0.0 : tr.time_s.front();
+        for (size_t i = 0; i < tr.size(); ++i) {
+            const double t = tr.time_s[i];
+            if (t + 1e-9 < next_tick) {
+                continue;
+            }
+            next_tick += 1.0 / p.fps;
+            ++ticks;
+            if (!tr.face[i]) {
+                continue;
+            }
+            const auto start = std::chrono::steady_clock::now();
+            analyzer.add_sample(cv::Scalar(tr.bgr[i][0], tr.bgr[i][1], tr.bgr[i][2]));
+            auto bpm = analyzer.calculate_bpm(p.min_bpm, p.max_bpm, false);
+            busy += std::chrono::steady_clock::now() - start;
+            if (bpm) {
+                estimate.push_back(*bpm);
+                reference.push_back(s.truth.mean_hr(t - score.latency_s, t));
+            }
+        }
+        input_seconds += tr.duration();
+    }
+    score.error = eval::error_stats(estimate, reference);
+    score.coverage = ticks ? static_cast<double>(estimate.size()) / ticks : 0.0;
+    score.cpu_ms_per_s = input_seconds > 0.0
+        ? std::chrono::duration<double, std::milli>(busy).count() / input_seconds : 0.0;
+    return score;
+}
+
+bool dominates(const Score& a, const Score& b) {
+    const bool no_worse = a.error.mae <= b.error.mae && a.latency_s <= b.latency_s && a.cpu_ms_per_s <= b.cpu_ms_per_s;
+    const bool better = a.error.mae < b.error.mae || a.latency_s < b.latency_s || a.cpu_ms_per_s < b.cpu_ms_per_s;
+    return no_worse && better;
+}
+
+std::expected<void, std::string> write_profile(const std::string& base, const std::string& out, const Params& p) {
+    try {
+        YAML::Node node = YAML::LoadFile(base);
+        node["camera"]["acquisition_fps"] = p.fps;
+        // A per-camera rate would override the tuned default, so it is replaced as well
+        if (YAML::Node cams = node["cameras"]) {
+            for (YAML::Node cam : cams) {
+                if (cam["acquisition_fps"]) {
+                    cam["acquisition_fps"] = p.fps;
+                }
+            }
+        }
+        node["analysis"]["window_duration_seconds"] = p.window_seconds;
+        node["analysis"]["min_bpm"] = p.min_bpm;
+        node["analysis"]["max_bpm"] = p.max_bpm;
+        std::ofstream file(out);
+        file << "# Tuned by HeartbeatAutotune from " << base << "\n" << node << "\n";
+        if (!file) {
+            return std::unexpected("Cannot write " + out);
+        }
+        return {};
+    } catch (const std::exception& e) {
+        return std::unexpected(std::string("Profile error: ") + e.what());
+    }
+}
+
+void print_usage() {
+    std::println(stderr, "Usage: HeartbeatAutotune [--fps L] [--window L] [--min-bpm L] [--max-bpm L] [--random N] [--seed S]\n"
+                         "                         [--jobs N] [--cache-dir DIR] [--config FILE] [--write-profile FILE] dataset_root");
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<double> fps_list{10.0, 15.0, 20.0, 30.0};
+    std::vector<double> window_list{4.0, 6.0, 8.5, 10.0, 12.0};
+    std::vector<double> min_list{40.0, 45.0, 50.0};
+    std::vector<double> max_list{150.0, 180.0, 200.0};
+    size_t random_points = 0;
+    unsigned seed = 1;
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::string cache_dir = ".hbm_traces", base_config = "config.yaml", profile_path, root;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--fps" && has_value) {
+            fps_list = parse_list(argv[++i]);
+        } else if (arg == "--window" && has_value) {
+            window_list = parse_list(argv[++i]);
+        } else if (arg == "--min-bpm" && has_value) {
+            min_list = parse_list(argv[++i]);
+        } else if (arg == "--max-bpm" && has_value) {
+            max_list = parse_list(argv[++i]);
+        } else if (arg == "--random" && has_value) {
+            random_points = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--seed" && has_value) {
+            seed = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--jobs" && has_value) {
+            jobs = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--cache-dir" && has_value) {
+            cache_dir = argv[++i];
+        } else if (arg == "--config" && has_value) {
+            base_config = argv[++i];
+        } else if (arg == "--write-profile" && has_value) {
+            profile_path = argv[++i];
+        } else if (arg.starts_with("--") || !root.empty()) {
+            print_usage();
+            return 2;
+        } else {
+            root = arg;
+        }
+    }
+    if (root.empty() || fps_list.empty() || window_list.empty() || min_list.empty() || max_list.empty()) {
+        print_usage();
+        return 2;
+    }
+    spdlog::set_level(spdlog::level::warn);
+
+    const auto entries = eval::discover_ubfc(root);
+    if (entries.empty()) {
+        std::println(stderr, "No subjects with video and ground truth under {}", root);
+        return 1;
+    }
+
+    // 1. Traces: load from cache, or run detection once per video (one FaceProcessor per worker,
+    //    all over one model that is only loaded if some trace is missing)
+    std::filesystem::create_directories(cache_dir);
+    std::shared_ptr<const FaceModel> model;
+    std::once_flag model_loaded;
+    std::vector<Subject> subjects(entries.size());
+    std::vector<std::string> errors(entries.size());
+    const auto extract_start = std::chrono::steady_clock::now();
+    std::atomic<size_t> extracted{0};
+    {
+        std::atomic<size_t> next{0};
+        std::vector<std::jthread> workers;
+        for (unsigned w = 0; w < std::min<size_t>(jobs, entries.size()); ++w) {
+            workers.emplace_back([&]() {
+                std::unique_ptr<FaceProcessor> processor;
+                for (size_t i = next++; i < entries.size(); i = next++) {
+                    const auto& e = entries[i];
+                    auto& s = subjects[i];
+                    s.name = e.name;
+                    auto truth = eval::load_ground_truth(e.dir);
+                    if (!truth) {
+                        errors[i] = truth.error();
+                        continue;
+                    }
+                    s.truth = std::move(*truth);
+                    const auto cached = std::filesystem::path(cache_dir) / (e.name + ".csv");
+                    std::error_code ec;
+                    if (std::filesystem::exists(cached, ec) &&
+                        std::filesystem::last_write_time(cached, ec) >= std::filesystem::last_write_time(e.video, ec)) {
+                        if (auto trace = eval::load_sample_trace(cached)) {
+                            s.trace = std::move(*trace);
+                            continue;
+                        }
+                    }
+                    if (!processor) {
+                        std::call_once(model_loaded, [&] { model = std::make_shared<const FaceModel>(MODEL_PATH); });
+                        processor = std::make_unique<FaceProcessor>(model);
+                    }
+                    s.trace = extract_trace(e.video, *processor);
+                    ++extracted;
+                    if (auto saved = eval::save_sample_trace(s.trace, cached); !saved) {
+                        spdlog::warn("{}", saved.error());
+                    }
+                }
+            });
+        }
+    }
+    std::vector<Subject> usable;
+    for (size_t i = 0; i < subjects.size(); ++i) {
+        if (!errors[i].empty()) {
+            std::println(stderr, "Skipping {}: {}", subjects[i].name, errors[i]);
+        } else if (subjects[i].trace.size() >= 2) {
+            usable.push_back(std::move(subjects[i]));
+        }
+    }
+    subjects = std::move(usable);
+    if (subjects.empty()) {
+        std::println(stderr, "No usable subjects");
+        return 1;
+    }
+    double min_trace_fps = subjects.front().trace.fps();
+    for (const auto& s : subjects) {
+        min_trace_fps = std::min(min_trace_fps, s.trace.fps());
+    }
+    std::println("{} subjects ({} traces extracted in {:.1f} s, {} cached), lowest native rate {:.1f} fps",
+        subjects.size(), extracted.load(),
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - extract_start).count(),
+        subjects.size() - extracted.load(), min_trace_fps);
+
+    // 2. Candidates: full grid, or uniform random points inside the grid's bounding box
+    std::vector<Params> candidates;
+    if (random_points > 0) {
+        std::mt19937 rng(seed);
+        auto pick = [&](const std::vector<double>& v, double step) {
+            const auto [lo, hi] = std::ranges::minmax(v);
+            return std::round(std::uniform_real_distribution<double>(lo, hi)(rng) / step) * step;
+        };
+        for (size_t i = 0; i < random_points; ++i) {
+            candidates.push_back({pick(fps_list, 0.5), pick(window_list, 0.5), pick(min_list, 1.0), pick(max_list, 1.0)});
+        }
+    } else {
+        for (const double f : fps_list)
+            for (const double w : window_list)
+                for (const double lo : min_list)
+                    for (const double hi : max_list)
+                        candidates.push_back({f, w, lo, hi});
+    }
+    // AppConfig clamps acquisition_fps to [10, 60], and a rate above the recording's cannot be replayed
+    std::erase_if(candidates, [&](const Params& p) {
+        return p.fps < 10.0 || p.fps > 60.0 || p.fps > min_trace_fps + 1e-6 || p.window_seconds <= 0.0 ||
+               p.min_bpm >= p.max_bpm;
+    });
+    if (candidates.empty()) {
+        std::println(stderr, "No valid candidates (acquisition fps must be within 10..min(60, {:.1f}))", min_trace_fps);
+        return 1;
+    }
+
+    // 3. Sweep: the subjects are shared read-only, each worker owns its analyzers
+    std::vector<Score> scores(candidates.size());
+    const auto sweep_start = std::chrono::steady_clock::now();
+    parallel_for(candidates.size(), jobs, [&](size_t i) { scores[i] = evaluate(candidates[i], subjects); });
+    std::println("{} candidates on {} threads in {:.1f} s", candidates.size(), std::min<size_t>(jobs, candidates.size()),
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - sweep_start).count());
+
+    std::erase_if(scores, [](const Score& s) { return s.error.n == 0; });
+    std::vector<Score> front;
+    for (const auto& s : scores) {
+        if (std::ranges::none_of(scores, [&](const Score& o) { return dominates(o, s); })) {
+            front.push_back(s);
+        }
+    }
+    if (front.empty()) {
+        std::println(stderr, "No candidate produced an estimate");
+        return 1;
+    }
+    std::ranges::sort(front, {}, [](const Score& s) { return s.error.mae; });
+
+    std::println("\nPareto front (accuracy / latency / CPU), {} of {} candidates:", front.size(), scores.size());
+    std::println("{:>6} {:>7} {:>7} {:>7}  {:>6} {:>6} {:>7} {:>8} {:>9} {:>8}",
+        "fps", "window", "min", "max", "MAE", "RMSE", "Pearson", "covered", "latency s", "cpu ms/s");
+    for (const auto& s : front) {
+        std::println("{:>6.1f} {:>7.1f} {:>7.0f} {:>7.0f}  {:>6.2f} {:>6.2f} {:>7.3f} {:>7.0f}% {:>9.1f} {:>8.3f}",
+            s.params.fps, s.params.window_seconds, s.params.min_bpm, s.params.max_bpm, s.error.mae, s.error.rmse,
+            s.error.pearson, 100.0 * s.coverage, s.latency_s, s.cpu_ms_per_s);
+    }
+
+    if (!profile_path.empty()) {
+        const Params& best = front.front().params;
+        if (auto written = write_profile(base_config, profile_path, best); !written) {
+            std::println(stderr, "{}", written.error());
+            return 1;
+        }
+        std::println("\nWrote {} (acquisition_fps {:.1f}, window {:.1f} s, {:.0f}-{:.0f} bpm)", profile_path,
+            best.fps, best.window_seconds, best.min_bpm, best.max_bpm);
+    }
+    return 0;
+}
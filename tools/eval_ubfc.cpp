@@ -0,0 +1,224 @@
+/**
+ * @file eval_ubfc.cpp
+ * @brief Accuracy evaluation on a UBFC-rPPG style dataset, one pipeline per worker thread.
+ *
+ * Usage: HeartbeatEval [--jobs N] [--config config.yaml] [--csv out.csv] dataset_root
+ * Each subject directory holds a video (vid.avi) and ground_truth.txt or gtdump.xmp.
+ * Frames are sampled at camera.acquisition_fps like the live app, and every BPM estimate
+ * is compared to the mean reference HR over the same analysis window. The dataset videos are
+ * not any configured camera, so the camera section's defaults apply and per-entry overrides
+ * under cameras: are ignored.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/videoio.hpp>
+#include <spdlog/spdlog.h>
+#include "Config.hpp"
+#include "Evaluation.hpp"
+#include "FaceProcessor.hpp"
+#include "HeartbeatAnalyzer.hpp"
+
+namespace {
+struct Params {
+    double acquisition_fps{10.0};
+    double window_seconds{8.5};
+    double min_bpm{45.0};
+    double max_bpm{180.0};
+};
+
+struct VideoResult {
+    std::string name;
+    std::string error;
+    size_t frames{0};
+    size_t samples{0};
+    size_t faces{0};
+    double seconds{0.0};
+    std::vector<double> estimate;
+    std::vector<double> reference;
+};
+
+VideoResult evaluate(const eval::DatasetEntry& entry, FaceProcessor& processor, const Params& p) {
+    VideoResult r;
+    r.name = entry.name;
+    auto gt = eval::load_ground_truth(entry.dir);
+    if (!gt) {
+        r.error = gt.error();
+        return r;
+    }
+    cv::VideoCapture cap(entry.video.string());
+    if (!cap.isOpened()) {
+        r.error = "cannot open " + entry.video.string();
+        return r;
+    }
+    const double video_fps = cap.get(cv::CAP_PROP_FPS) > 0.0 ? cap.get(cv::CAP_PROP_FPS) : 30.0;
+    const double acq_fps = std::min(p.acquisition_fps, video_fps);
+    const int window = std::max(2, static_cast<int>(std::lround(p.window_seconds * acq_fps)));
+    HeartbeatAnalyzer analyzer(window, acq_fps);
+
+    cv::Mat frame;
+    double next_sample_t = 0.0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0;; ++i) {
+        const double t = static_cast<double>(i) / video_fps;
+        // Frames between acquisition ticks are grabbed but never decoded to pixels
+        if (t + 1e-9 < next_sample_t) {
+            if (!cap.grab()) {
+                break;
+            }
+            ++r.frames;
+            continue;
+        }
+        if (!cap.read(frame)) {
+            break;
+        }
+        ++r.frames;
+        ++r.samples;
+        next_sample_t += 1.0 / acq_fps;
+        auto face = processor.get_central_face(frame);
+        if (!face) {
+            continue;
+        }
+        ++r.faces;
+        analyzer.add_sample(processor.get_avg_bgr(processor.get_stabilized_forehead(frame, *face)));
+        if (auto bpm = analyzer.calculate_bpm(p.min_bpm, p.max_bpm, false)) {
+            r.estimate.push_back(*bpm);
+            r.reference.push_back(gt->mean_hr(t - p.window_seconds, t));
+        }
+    }
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return r;
+}
+
+double mean(const std::vector<double>& v) {
+    double s = 0.0;
+    for (const double x : v) {
+        s += x;
+    }
+    return v.empty() ? 0.0 : s / static_cast<double>(v.size());
+}
+
+void print_usage() {
+    std::println(stderr, "Usage: HeartbeatEval [--jobs N] [--config config.yaml] [--csv out.csv] dataset_root");
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+    std::string config_path, csv_path, root;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--config" && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (arg.starts_with("--") || !root.empty()) {
+            print_usage();
+            return 2;
+        } else {
+            root = arg;
+        }
+    }
+    if (root.empty()) {
+        print_usage();
+        return 2;
+    }
+    spdlog::set_level(spdlog::level::warn);
+
+    Params params;
+    if (!config_path.empty()) {
+        auto cfg = AppConfig::load(config_path);
+        if (!cfg) {
+            std::println(stderr, "Config Error: {}", cfg.error());
+            return 1;
+        }
+        // The camera defaults, not cameras[0]: the videos are not one of the configured sources
+        params = {cfg->camera.acquisition_fps, cfg->analysis.window_duration_seconds,
+                  cfg->analysis.min_bpm, cfg->analysis.max_bpm};
+    }
+
+    const auto entries = eval::discover_ubfc(root);
+    if (entries.empty()) {
+        std::println(stderr, "No subjects with video and ground truth under {}", root);
+        return 1;
+    }
+    jobs = std::min<unsigned>(jobs, static_cast<unsigned>(entries.size()));
+    std::println("{} subjects, {} workers, acquisition {:.1f} fps, window {:.1f} s, band {:.0f}-{:.0f} bpm",
+        entries.size(), jobs, params.acquisition_fps, params.window_seconds, params.min_bpm, params.max_bpm);
+
+    // Workers pull the next subject index; each runs its own FaceProcessor over one shared model
+    const auto model = std::make_shared<const FaceModel>(MODEL_PATH);
+    std::vector<VideoResult> results(entries.size());
+    std::atomic<size_t> next{0};
+    std::mutex print_mtx;
+    const auto wall_start = std::chrono::steady_clock::now();
+    {
+        std::vector<std::jthread> workers;
+        for (unsigned w = 0; w < jobs; ++w) {
+            workers.emplace_back([&]() {
+                FaceProcessor processor(model);
+                for (size_t i = next++; i < entries.size(); i = next++) {
+                    results[i] = evaluate(entries[i], processor, params);
+                    const auto& r = results[i];
+                    std::lock_guard lock(print_mtx);
+                    if (!r.error.empty()) {
+                        std::println("{:<16} error: {}", r.name, r.error);
+                    } else {
+                        const auto s = eval::error_stats(r.estimate, r.reference);
+                        std::println("{:<16} frames {:>5}  {:>6.1f} fps  faces {:>3.0f}%  est {:>5.1f} / ref {:>5.1f} bpm  MAE {:>5.2f}",
+                            r.name, r.frames, r.seconds > 0.0 ? r.frames / r.seconds : 0.0,
+                            r.samples ? 100.0 * r.faces / r.samples : 0.0, mean(r.estimate), mean(r.reference), s.mae);
+                    }
+                }
+            });
+        }
+    }
+    const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    std::vector<double> all_est, all_ref, video_est, video_ref;
+    size_t total_frames = 0;
+    for (const auto& r : results) {
+        total_frames += r.frames;
+        if (!r.error.empty() || r.estimate.empty()) {
+            continue;
+        }
+        all_est.insert(all_est.end(), r.estimate.begin(), r.estimate.end());
+        all_ref.insert(all_ref.end(), r.reference.begin(), r.reference.end());
+        video_est.push_back(mean(r.estimate));
+        video_ref.push_back(mean(r.reference));
+    }
+    const auto per_window = eval::error_stats(all_est, all_ref);
+    const auto per_video = eval::error_stats(video_est, video_ref);
+    std::println("\nPer window (n={}): MAE {:.2f}  RMSE {:.2f}  Pearson {:.3f}",
+        per_window.n, per_window.mae, per_window.rmse, per_window.pearson);
+    std::println("Per video  (n={}): MAE {:.2f}  RMSE {:.2f}  Pearson {:.3f}",
+        per_video.n, per_video.mae, per_video.rmse, per_video.pearson);
+    std::println("Throughput: {} frames in {:.1f} s ({:.1f} fps aggregate)", total_frames, wall,
+        wall > 0.0 ? total_frames / wall : 0.0);
+
+    if (!csv_path.empty()) {
+        std::ofstream csv(csv_path);
+        csv << "subject,frames,seconds,fps,face_ratio,estimates,mean_est_bpm,mean_ref_bpm,mae,rmse,pearson,error\n";
+        for (const auto& r : results) {
+            const auto s = eval::error_stats(r.estimate, r.reference);
+            csv << std::format("{},{},{:.3f},{:.2f},{:.3f},{},{:.2f},{:.2f},{:.3f},{:.3f},{:.4f},{}\n",
+                r.name, r.frames, r.seconds, r.seconds > 0.0 ? r.frames / r.seconds : 0.0,
+                r.samples ? double(r.faces) / r.samples : 0.0, s.n, mean(r.estimate), mean(r.reference),
+                s.mae, s.rmse, s.pearson, r.error);
+        }
+    }
+    return 0;
+}
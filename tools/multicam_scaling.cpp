@@ -0,0 +1,191 @@
+/**
+ * @file multicam_scaling.cpp
+ * @brief CPU scaling of the multi-camera app: N file-backed sources stand in for cameras, each
+ *        running the app's CameraPipeline on one shared model and scheduler, for N = 1, 2, 4, ...
+ *
+ * Usage: HeartbeatMultiCam [--cameras 1,2,4] [--duration S] [--config config.yaml] [--csv out.csv] video...
+ * Videos are assigned to cameras round-robin and loop, and play in real time like a camera,
+ * so a pipeline that falls behind skips frames instead of slowing the video down. Each row
+ * reports whether every camera kept its acquisition rate and what CPU that cost: with
+ * independent pipelines, CPU per camera should stay flat as cameras are added until the
+ * cores run out.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <print>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "CameraPipeline.hpp"
+#include "Config.hpp"
+#include "FaceModel.hpp"
+#include "ProcessStats.hpp"
+#include "WorkStealingPool.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Row {
+    size_t cameras{0};
+    double mean_rate{0.0}; // Samples/s per camera
+    double min_rate{0.0};
+    size_t kept_up{0};     // Cameras at >= 95% of their acquisition rate
+    double cores{0.0};     // Process CPU seconds per wall second
+    double cpu_ms_per_frame{0.0};
+    double face_pct{0.0};
+    uint64_t overruns{0};
+    double rss_mib{0.0};
+};
+
+void print_usage() {
+    std::println(stderr, "Usage: HeartbeatMultiCam [--cameras 1,2,4] [--duration S] [--config config.yaml] "
+                         "[--csv out.csv] video...");
+}
+
+std::vector<size_t> parse_counts(const std::string& list) {
+    std::vector<size_t> counts;
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        const int n = std::atoi(item.c_str());
+        if (n > 0) {
+            counts.push_back(std::min(static_cast<size_t>(n), AppConfig::kMaxCameras));
+        }
+    }
+    return counts;
+}
+
+Row run(const AppConfig& base, const std::vector<std::string>& videos, size_t count, double duration,
+        const std::shared_ptr<const FaceModel>& model) {
+    AppConfig config = base;
+    config.cameras.clear();
+    for (size_t i = 0; i < count; ++i) {
+        AppConfig::CameraSource source{"file" + std::to_string(i), videos[i % videos.size()], 0, 0,
+            base.camera.fps, base.camera.acquisition_fps, base.camera.frame_roi, true};
+        config.cameras.push_back(std::move(source));
+    }
+
+    WorkStealingPool scheduler(WorkStealingPool::Options{
+        .threads = config.scheduler.threads,
+        .pin_workers = config.scheduler.pin_workers,
+        .first_core = config.scheduler.first_core,
+        .spin = std::chrono::microseconds(config.scheduler.spin_us),
+        .name = "sched"});
+    std::vector<std::unique_ptr<CameraPipeline>> cameras;
+    for (size_t i = 0; i < count; ++i) {
+        cameras.push_back(std::make_unique<CameraPipeline>(i, config.cameras[i], config, model, scheduler));
+    }
+
+    const double cpu_start = process_stats::cpu_seconds();
+    const auto start = Clock::now();
+    {
+        std::vector<std::jthread> threads;
+        for (auto& camera : cameras) {
+            threads.emplace_back([&camera](std::stop_token st) { camera->run(st); });
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(duration));
+    }
+    const double wall = std::chrono::duration<double>(Clock::now() - start).count();
+    const double cpu = process_stats::cpu_seconds() - cpu_start;
+
+    Row row;
+    row.cameras = count;
+    row.min_rate = 1e300;
+    uint64_t frames = 0, faces = 0;
+    for (const auto& camera : cameras) {
+        const auto s = camera->stats();
+        const double rate = static_cast<double>(s.frames) / wall;
+        row.mean_rate += rate / static_cast<double>(count);
+        row.min_rate = std::min(row.min_rate, rate);
+        row.kept_up += rate >= 0.95 * config.cameras[camera->index()].acquisition_fps ? 1 : 0;
+        row.overruns += s.overruns;
+        frames += s.frames;
+        faces += s.faces;
+    }
+    row.cores = cpu / wall;
+    row.cpu_ms_per_frame = frames ? 1000.0 * cpu / static_cast<double>(frames) : 0.0;
+    row.face_pct = frames ? 100.0 * static_cast<double>(faces) / static_cast<double>(frames) : 0.0;
+    row.rss_mib = static_cast<double>(process_stats::current_rss_bytes()) / (1024.0 * 1024.0);
+    return row;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<size_t> counts;
+    double duration = 20.0;
+    std::string config_path = "config.yaml";
+    std::string csv_path;
+    std::vector<std::string> videos;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--cameras" && i + 1 < argc) {
+            counts = parse_counts(argv[++i]);
+        } else if (arg == "--duration" && i + 1 < argc) {
+            duration = std::max(1.0, std::atof(argv[++i]));
+        } else if (arg == "--config" && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (arg.starts_with("--")) {
+            print_usage();
+            return 2;
+        } else {
+            videos.push_back(arg);
+        }
+    }
+    if (videos.empty()) {
+        print_usage();
+        return 2;
+    }
+    if (counts.empty()) {
+        const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t n = 1; n <= std::min(cores, AppConfig::kMaxCameras); n *= 2) {
+            counts.push_back(n);
+        }
+    }
+    auto config = AppConfig::load(config_path);
+    if (!config) {
+        std::println(stderr, "Config Error: {}", config.error());
+        return 1;
+    }
+    spdlog::set_level(spdlog::level::warn); // Overruns are counted per row rather than logged
+
+    const auto model = std::make_shared<const FaceModel>(MODEL_PATH);
+    std::println("{} video(s), {:.0f} s per row, acquisition {:.1f} fps, scheduler {} workers{}",
+        videos.size(), duration, config->camera.acquisition_fps, config->scheduler.threads,
+        config->scheduler.parallel_detection ? ", parallel detection" : "");
+    std::println("{:>7} {:>10} {:>9} {:>8} {:>7} {:>11} {:>11} {:>6} {:>9} {:>8}",
+        "cameras", "samples/s", "min", "kept up", "cores", "cpu ms/frm", "cpu/camera", "faces", "overruns", "rss MiB");
+
+    std::vector<Row> rows;
+    for (const size_t count : counts) {
+        Row row;
+        try {
+            row = run(*config, videos, count, duration, model);
+        } catch (const std::exception& e) {
+            std::println(stderr, "{} cameras: {}", count, e.what());
+            return 1;
+        }
+        std::println("{:>7} {:>10.2f} {:>9.2f} {:>5}/{:<2} {:>7.2f} {:>11.1f} {:>10.0f}% {:>5.0f}% {:>9} {:>8.1f}",
+            row.cameras, row.mean_rate, row.min_rate, row.kept_up, row.cameras, row.cores, row.cpu_ms_per_frame,
+            100.0 * row.cores / static_cast<double>(row.cameras), row.face_pct, row.overruns, row.rss_mib);
+        rows.push_back(row);
+    }
+
+    if (!csv_path.empty()) {
+        std::ofstream csv(csv_path);
+        csv << "cameras,samples_per_s,min_samples_per_s,kept_up,cores,cpu_ms_per_frame,face_pct,overruns,rss_mib\n";
+        for (const auto& r : rows) {
+            csv << r.cameras << ',' << r.mean_rate << ',' << r.min_rate << ',' << r.kept_up << ',' << r.cores << ','
+                << r.cpu_ms_per_frame << ',' << r.face_pct << ',' << r.overruns << ',' << r.rss_mib << '\n';
+        }
+        std::println("Wrote {}", csv_path);
+    }
+    return 0;
+}
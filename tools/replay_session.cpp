@@ -0,0 +1,171 @@
+/**
+ * @file replay_session.cpp
+ * @brief Re-runs the analysis stage over a recorded session (.hbms) as fast as possible.
+ *
+ * Usage: HeartbeatReplay [--config config.yaml] [--repeat N] [--csv out.csv] [--no-verify] session.hbms
+ * Capture, detection and ROI extraction are skipped: the stored ROI means are fed to
+ * HeartbeatAnalyzer in their original order, with the window and BPM band from the config and
+ * the primary camera's (cameras[0]) acquisition rate, exactly as main does live. Every estimate is compared bit for bit with the BPM the live run
+ * reported for the same frame; any difference makes the exit status 1, so the tool doubles as
+ * a deterministic regression check and an analysis-stage benchmark on build machines.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <expected>
+#include <format>
+#include <fstream>
+#include <print>
+#include <string>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "Config.hpp"
+#include "HeartbeatAnalyzer.hpp"
+#include "SessionRecording.hpp"
+
+namespace {
+struct ReplayResult {
+    size_t frames{0};
+    size_t samples{0};
+    size_t estimates{0};
+    size_t mismatches{0};
+    size_t first_mismatch{0};
+    double seconds{0.0};
+};
+
+bool same_bits(double a, double b) {
+    return std::bit_cast<uint64_t>(a) == std::bit_cast<uint64_t>(b);
+}
+
+// Chunks are decoded one at a time, so memory stays flat on hours-long sessions
+std::expected<ReplayResult, std::string> replay(const SessionReader& session, const AppConfig& config,
+                                                std::ofstream* csv) {
+    const double window_seconds = std::max(1.0, config.analysis.window_duration_seconds);
+    const double acquisition_fps = config.cameras[0].acquisition_fps; // Sessions record the primary camera
+    const int window_size = std::max(2, static_cast<int>(std::lround(window_seconds * acquisition_fps)));
+    HeartbeatAnalyzer analyzer(window_size, acquisition_fps);
+
+    ReplayResult r;
+    std::vector<SessionFrame> chunk;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t c = 0; c < session.chunk_count(); ++c) {
+        if (auto ok = session.read_chunk(c, chunk); !ok) {
+            return std::unexpected(ok.error());
+        }
+        for (const auto& frame : chunk) {
+            ++r.frames;
+            if (!frame.face) {
+                continue;
+            }
+            ++r.samples;
+            analyzer.add_sample(cv::Scalar(frame.bgr[0], frame.bgr[1], frame.bgr[2]));
+            auto bpm = analyzer.calculate_bpm(config.analysis.min_bpm, config.analysis.max_bpm, false);
+            if (bpm) {
+                ++r.estimates;
+                if (csv) {
+                    *csv << std::format("{:.6f},{},{}\n", frame.t_ns / 1e9, *bpm, analyzer.confidence());
+                }
+            }
+            const bool live_had_bpm = !std::isnan(frame.bpm);
+            if (live_had_bpm != bpm.has_value() || (bpm && !same_bits(*bpm, frame.bpm))) {
+                if (r.mismatches++ == 0) {
+                    r.first_mismatch = r.frames - 1;
+                }
+            }
+        }
+    }
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return r;
+}
+
+void print_usage() {
+    std::println(stderr, "Usage: HeartbeatReplay [--config config.yaml] [--repeat N] [--csv out.csv] [--no-verify] session.hbms");
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string config_path = "config.yaml", csv_path, session_path;
+    int repeat = 1;
+    bool verify = true;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--config" && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (arg == "--no-verify") {
+            verify = false;
+        } else if (arg.starts_with("--") || !session_path.empty()) {
+            print_usage();
+            return 2;
+        } else {
+            session_path = arg;
+        }
+    }
+    if (session_path.empty()) {
+        print_usage();
+        return 2;
+    }
+    spdlog::set_level(spdlog::level::warn);
+
+    auto config = AppConfig::load(config_path);
+    if (!config) {
+        std::println(stderr, "Config Error: {}", config.error());
+        return 1;
+    }
+    auto session = SessionReader::open(session_path);
+    if (!session) {
+        std::println(stderr, "{}", session.error());
+        return 1;
+    }
+
+    const SessionHeader& h = session->header();
+    const double window_seconds = std::max(1.0, config->analysis.window_duration_seconds);
+    const double acquisition_fps = config->cameras[0].acquisition_fps;
+    std::println("{}: {} frames in {} chunks, {:.1f} KiB{}", session_path, session->frame_count(),
+        session->chunk_count(), session->file_bytes() / 1024.0, session->truncated() ? " (truncated tail ignored)" : "");
+    if (h.acquisition_fps != acquisition_fps || h.window_seconds != window_seconds ||
+        h.min_bpm != config->analysis.min_bpm || h.max_bpm != config->analysis.max_bpm) {
+        std::println("note: recorded with acquisition_fps {} / window {} s / {}-{} bpm; replaying with {} / {} s / {}-{} bpm",
+            h.acquisition_fps, h.window_seconds, h.min_bpm, h.max_bpm, acquisition_fps, window_seconds,
+            config->analysis.min_bpm, config->analysis.max_bpm);
+        if (verify) {
+            std::println("note: settings differ, so BPM verification is skipped");
+            verify = false;
+        }
+    }
+
+    std::ofstream csv;
+    if (!csv_path.empty()) {
+        csv.open(csv_path);
+        csv << "t_s,bpm,confidence\n";
+    }
+    ReplayResult result;
+    double best_seconds = 0.0;
+    for (int run = 0; run < repeat; ++run) {
+        auto r = replay(*session, *config, run == 0 && csv.is_open() ? &csv : nullptr);
+        if (!r) {
+            std::println(stderr, "{}", r.error());
+            return 1;
+        }
+        best_seconds = run == 0 ? r->seconds : std::min(best_seconds, r->seconds);
+        result = *r;
+    }
+
+    std::println("{} samples, {} estimates; best of {}: {:.3f} s ({:.0f} samples/s)", result.samples, result.estimates,
+        repeat, best_seconds, best_seconds > 0.0 ? result.samples / best_seconds : 0.0);
+    if (verify) {
+        if (result.mismatches > 0) {
+            std::println("FAIL: {} BPM values differ from the live run (first at frame {})", result.mismatches,
+                result.first_mismatch);
+            return 1;
+        }
+        std::println("OK: BPM output is bit-identical to the live run");
+    }
+    return 0;
+}
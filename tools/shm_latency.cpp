@@ -0,0 +1,94 @@
+/**
+ * @file shm_latency.cpp
+ * @brief Measures publish-to-observe latency of the shared-memory HUD channel between two processes.
+ *
+ * Usage: HeartbeatShmLatency [samples] [interval_us]
+ * The tool acts as the writer and re-launches itself with --reader as the consumer.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+#include "SharedHudReader.hpp"
+#include "SharedHudWriter.hpp"
+
+namespace {
+constexpr char kChannel[] = "HeartbeatMonitorHUD_latency";
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int run_reader(uint64_t samples) {
+    std::expected<SharedHudReader, std::string> reader = std::unexpected("not opened");
+    const auto open_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!(reader = SharedHudReader::open(kChannel)) && std::chrono::steady_clock::now() < open_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!reader) {
+        std::println(stderr, "Reader: {}", reader.error());
+        return 1;
+    }
+
+    std::vector<double> latencies_us;
+    latencies_us.reserve(samples);
+    uint64_t last_count = 0;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (last_count < samples && std::chrono::steady_clock::now() < deadline) {
+        if (auto sample = reader->poll()) {
+            latencies_us.push_back((now_ns() - sample->timestamp_ns) / 1000.0);
+            last_count = sample->update_count;
+        }
+    }
+    if (latencies_us.empty()) {
+        std::println(stderr, "Reader: no samples observed");
+        return 1;
+    }
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    auto pct = [&](double p) {
+        return latencies_us[std::min(latencies_us.size() - 1, static_cast<size_t>(p * latencies_us.size()))];
+    };
+    std::println("observed {}/{} updates; latency us: p50 {:.2f}, p90 {:.2f}, p99 {:.2f}, max {:.2f}",
+        latencies_us.size(), samples, pct(0.50), pct(0.90), pct(0.99), latencies_us.back());
+    return 0;
+}
+
+int run_writer(const char* self, uint64_t samples, int interval_us) {
+    auto writer = SharedHudWriter::create(kChannel, cv::Size(0, 0));
+    if (!writer) {
+        std::println(stderr, "Writer: {}", writer.error());
+        return 1;
+    }
+
+    int reader_status = -1;
+    std::jthread reader_process([&]() {
+        const std::string cmd = std::format("\"{}\" --reader {}", self, samples);
+        reader_status = std::system(cmd.c_str());
+    });
+    // Give the reader time to map the channel before the first publish
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    for (uint64_t i = 0; i < samples; ++i) {
+        writer->publish_bpm(60.0 + static_cast<double>(i % 120), 1.0);
+        std::this_thread::sleep_for(std::chrono::microseconds(interval_us));
+    }
+    reader_process.join();
+    return reader_status == 0 ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && std::string(argv[1]) == "--reader") {
+        return run_reader(std::stoull(argv[2]));
+    }
+    const uint64_t samples = argc > 1 ? std::stoull(argv[1]) : 10000;
+    const int interval_us = argc > 2 ? std::stoi(argv[2]) : 200;
+    return run_writer(argv[0], samples, interval_us);
+}
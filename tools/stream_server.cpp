@@ -0,0 +1,328 @@
+/**
+ * @file stream_server.cpp
+ * @brief Many video streams in one process: per-stream analyzers, with detection and landmark jobs
+ *        from every stream scheduled on one shared work-stealing pool.
+ *
+ * Usage: HeartbeatStreamServer [--streams N] [--jobs N] [--duration S] [--report S]
+ *                              [--config config.yaml] [--csv out.csv] video...
+ * Videos are assigned to streams round-robin, so --streams above the video count replays the same
+ * files as extra streams. With --duration every stream loops its video until time is up; without
+ * it each stream plays its video once. Frames are sampled at camera.acquisition_fps like the app;
+ * streams are not configured cameras, so per-entry overrides under cameras: do not apply.
+ *
+ * Fairness: a stream has at most one job in flight. Its frame job (decode + detect) re-queues the
+ * stream at the back of the pool's FIFO injection queue once the frame is done, and the landmark
+ * job (predict + ROI + analysis) it spawns stays on the worker's own deque at High priority, so a
+ * detected face finishes before any new frame is started. Every stream therefore gets one frame per
+ * round, however cheap its frames are.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <print>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/videoio.hpp>
+#include <spdlog/spdlog.h>
+#include "Config.hpp"
+#include "FaceProcessor.hpp"
+#include "HeartbeatAnalyzer.hpp"
+#include "ProcessStats.hpp"
+#include "WorkStealingPool.hpp"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct Params {
+    double acquisition_fps{10.0};
+    double window_seconds{8.5};
+    double min_bpm{45.0};
+    double max_bpm{180.0};
+};
+
+struct Stream {
+    size_t id{0};
+    std::string source;
+    cv::VideoCapture cap;
+    double video_fps{30.0};
+    double acq_fps{10.0};
+    std::unique_ptr<HeartbeatAnalyzer> analyzer;
+
+    // Touched only by the stream's single in-flight job
+    cv::Mat frame;
+    size_t pass_frames{0};   // Frames read in the current pass over the video
+    double pass_offset{0.0}; // Stream time at which the current pass started (looping)
+    double next_sample_t{0.0};
+    size_t decoded{0};
+    size_t faces{0};
+    size_t estimates{0};
+    double bpm_sum{0.0};
+    double last_bpm{std::numeric_limits<double>::quiet_NaN()};
+    int64_t busy_ns{0};
+    Clock::time_point finished_at;
+
+    std::atomic<size_t> samples{0}; // Also read by the progress reporter
+};
+
+struct Context {
+    WorkStealingPool& pool;
+    std::vector<std::unique_ptr<FaceProcessor>>& processors; // One per pool worker
+    Params params;
+    bool loop{false};
+    Clock::time_point deadline{Clock::time_point::max()};
+    std::atomic<size_t> active{0};
+};
+
+int64_t ns_since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+}
+
+// Advances to the next acquisition tick and decodes that frame into s.frame. Frames between ticks
+// are grabbed but never decoded to pixels. At the end of the video, loops if asked.
+bool next_sample(Stream& s, bool loop) {
+    for (;;) {
+        const double t = s.pass_offset + static_cast<double>(s.pass_frames) / s.video_fps;
+        const bool skip = t + 1e-9 < s.next_sample_t;
+        if (skip ? s.cap.grab() : s.cap.read(s.frame)) {
+            ++s.pass_frames;
+            ++s.decoded;
+            if (!skip) {
+                s.next_sample_t += 1.0 / s.acq_fps;
+                return true;
+            }
+            continue;
+        }
+        if (!loop || s.pass_frames == 0 || !s.cap.open(s.source)) {
+            return false;
+        }
+        s.pass_offset = t;
+        s.pass_frames = 0;
+    }
+}
+
+void finish(Context& ctx, Stream& s) {
+    s.finished_at = Clock::now();
+    s.frame.release();
+    ctx.active.fetch_sub(1, std::memory_order_release);
+}
+
+void frame_job(Context& ctx, Stream& s);
+
+void schedule(Context& ctx, Stream& s) {
+    ctx.pool.inject([&ctx, &s] { frame_job(ctx, s); });
+}
+
+void landmark_job(Context& ctx, Stream& s, const dlib::rectangle& face) {
+    const auto start = Clock::now();
+    const FaceProcessor& processor = *ctx.processors[static_cast<size_t>(ctx.pool.current_worker())];
+    const auto landmarks = processor.predict_landmarks(s.frame, face);
+    s.analyzer->add_sample(processor.get_avg_bgr(processor.get_stabilized_forehead(s.frame, landmarks)));
+    if (auto bpm = s.analyzer->calculate_bpm(ctx.params.min_bpm, ctx.params.max_bpm, false)) {
+        ++s.estimates;
+        s.bpm_sum += *bpm;
+        s.last_bpm = *bpm;
+    }
+    ++s.faces;
+    s.busy_ns += ns_since(start);
+    s.samples.fetch_add(1, std::memory_order_relaxed);
+    schedule(ctx, s);
+}
+
+void frame_job(Context& ctx, Stream& s) {
+    if (Clock::now() >= ctx.deadline) {
+        finish(ctx, s);
+        return;
+    }
+    const auto start = Clock::now();
+    if (!next_sample(s, ctx.loop)) {
+        finish(ctx, s);
+        return;
+    }
+    FaceProcessor& processor = *ctx.processors[static_cast<size_t>(ctx.pool.current_worker())];
+    auto face = processor.detect_central_face(s.frame);
+    s.busy_ns += ns_since(start);
+    if (!face) {
+        s.samples.fetch_add(1, std::memory_order_relaxed);
+        schedule(ctx, s);
+        return;
+    }
+    // Landmarks right behind on this worker (frame still in cache); idle workers may steal it
+    ctx.pool.submit([&ctx, &s, rect = *face] { landmark_job(ctx, s, rect); }, WorkStealingPool::Priority::High);
+}
+
+// Jain's index: 1 when every stream got the same rate, 1/n when one got everything
+double jain_fairness(const std::vector<double>& rates) {
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (const double r : rates) {
+        sum += r;
+        sum_sq += r * r;
+    }
+    return sum_sq > 0.0 ? sum * sum / (static_cast<double>(rates.size()) * sum_sq) : 1.0;
+}
+
+void print_usage() {
+    std::println(stderr, "Usage: HeartbeatStreamServer [--streams N] [--jobs N] [--duration S] [--report S] "
+                         "[--config config.yaml] [--csv out.csv] video...");
+}
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t stream_count = 0;
+    unsigned jobs = 0;
+    double duration = 0.0;
+    double report_seconds = 5.0;
+    std::string config_path, csv_path;
+    std::vector<std::string> videos;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--streams" && i + 1 < argc) {
+            stream_count = static_cast<size_t>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--jobs" && i + 1 < argc) {
+            jobs = static_cast<unsigned>(std::max(1, std::atoi(argv[++i])));
+        } else if (arg == "--duration" && i + 1 < argc) {
+            duration = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--report" && i + 1 < argc) {
+            report_seconds = std::max(0.1, std::atof(argv[++i]));
+        } else if (arg == "--config" && i + 1 < argc) {
+            config_path = argv[++i];
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csv_path = argv[++i];
+        } else if (arg.starts_with("--")) {
+            print_usage();
+            return 2;
+        } else {
+            videos.push_back(arg);
+        }
+    }
+    if (videos.empty()) {
+        print_usage();
+        return 2;
+    }
+    spdlog::set_level(spdlog::level::warn);
+
+    Params params;
+    if (!config_path.empty()) {
+        auto cfg = AppConfig::load(config_path);
+        if (!cfg) {
+            std::println(stderr, "Config Error: {}", cfg.error());
+            return 1;
+        }
+        // The camera defaults, not cameras[0]: streams are not one of the configured sources
+        params = {cfg->camera.acquisition_fps, cfg->analysis.window_duration_seconds,
+                  cfg->analysis.min_bpm, cfg->analysis.max_bpm};
+    }
+    if (stream_count == 0) {
+        stream_count = videos.size();
+    }
+
+    std::vector<std::unique_ptr<Stream>> streams;
+    for (size_t i = 0; i < stream_count; ++i) {
+        auto s = std::make_unique<Stream>();
+        s->id = i;
+        s->source = videos[i % videos.size()];
+        if (!s->cap.open(s->source)) {
+            std::println(stderr, "Skipping stream {}: cannot open {}", i, s->source);
+            continue;
+        }
+        s->video_fps = s->cap.get(cv::CAP_PROP_FPS) > 0.0 ? s->cap.get(cv::CAP_PROP_FPS) : 30.0;
+        s->acq_fps = std::min(params.acquisition_fps, s->video_fps);
+        const int window = std::max(2, static_cast<int>(std::lround(params.window_seconds * s->acq_fps)));
+        s->analyzer = std::make_unique<HeartbeatAnalyzer>(window, s->acq_fps);
+        streams.push_back(std::move(s));
+    }
+    if (streams.empty()) {
+        std::println(stderr, "No stream could be opened");
+        return 1;
+    }
+
+    WorkStealingPool pool(jobs);
+    const auto model = std::make_shared<const FaceModel>(MODEL_PATH);
+    std::vector<std::unique_ptr<FaceProcessor>> processors;
+    for (unsigned i = 0; i < pool.size(); ++i) {
+        processors.push_back(std::make_unique<FaceProcessor>(model));
+    }
+    std::println("{} streams over {} videos, {} workers, acquisition {:.1f} fps, {}", streams.size(), videos.size(),
+        pool.size(), params.acquisition_fps, duration > 0.0 ? std::format("looping for {:.0f} s", duration) : "one pass");
+
+    Context ctx{pool, processors, params};
+    const auto start = Clock::now();
+    if (duration > 0.0) {
+        ctx.loop = true;
+        ctx.deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(duration));
+    }
+    ctx.active = streams.size();
+    for (auto& s : streams) {
+        schedule(ctx, *s);
+    }
+
+    // Progress: aggregate sample rate per interval until every stream has finished
+    size_t last_samples = 0;
+    auto last_report = start;
+    while (ctx.active.load(std::memory_order_acquire) > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        const auto now = Clock::now();
+        const double interval = std::chrono::duration<double>(now - last_report).count();
+        if (interval < report_seconds) {
+            continue;
+        }
+        size_t samples = 0;
+        for (const auto& s : streams) {
+            samples += s->samples.load(std::memory_order_relaxed);
+        }
+        std::println("[{:>6.1f} s] {:>3}/{} streams active  {:>8.1f} samples/s",
+            std::chrono::duration<double>(now - start).count(), ctx.active.load(), streams.size(),
+            static_cast<double>(samples - last_samples) / interval);
+        last_samples = samples;
+        last_report = now;
+    }
+    pool.wait_idle();
+    const double wall = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::println("\n{:>4} {:<28} {:>8} {:>6} {:>9} {:>10} {:>8} {:>8}",
+        "id", "source", "samples", "faces", "samples/s", "ms/sample", "mean bpm", "last");
+    std::vector<double> rates;
+    size_t total_samples = 0, total_decoded = 0, kept_up = 0;
+    for (const auto& s : streams) {
+        const size_t samples = s->samples.load();
+        const double lifetime = std::chrono::duration<double>(s->finished_at - start).count();
+        const double rate = lifetime > 0.0 ? static_cast<double>(samples) / lifetime : 0.0;
+        rates.push_back(rate);
+        total_samples += samples;
+        total_decoded += s->decoded;
+        kept_up += rate + 1e-9 >= s->acq_fps ? 1 : 0;
+        const std::string name = s->source.size() > 28 ? "..." + s->source.substr(s->source.size() - 25) : s->source;
+        std::println("{:>4} {:<28} {:>8} {:>5.0f}% {:>9.1f} {:>10.2f} {:>8.1f} {:>8.1f}", s->id, name, samples,
+            samples ? 100.0 * static_cast<double>(s->faces) / static_cast<double>(samples) : 0.0, rate,
+            samples ? static_cast<double>(s->busy_ns) / 1e6 / static_cast<double>(samples) : 0.0,
+            s->estimates ? s->bpm_sum / static_cast<double>(s->estimates) : 0.0, s->last_bpm);
+    }
+    const auto stats = pool.stats();
+    std::println("\nAggregate: {:.1f} samples/s, {:.1f} decoded frames/s over {:.1f} s", total_samples / wall,
+        total_decoded / wall, wall);
+    std::println("Fairness (Jain): {:.3f}   streams at >= acquisition fps: {}/{}", jain_fairness(rates), kept_up,
+        streams.size());
+    std::println("Pool: {} tasks, {} stolen, {} via FIFO, {} parks   peak RSS {:.1f} MB", stats.executed,
+        stats.stolen, stats.injected, stats.parks, static_cast<double>(process_stats::peak_rss_bytes()) / (1024.0 * 1024.0));
+
+    if (!csv_path.empty()) {
+        std::ofstream csv(csv_path);
+        csv << "stream,source,samples,faces,samples_per_s,busy_ms_per_sample,mean_bpm,last_bpm\n";
+        for (size_t i = 0; i < streams.size(); ++i) {
+            const auto& s = *streams[i];
+            const size_t samples = s.samples.load();
+            csv << std::format("{},{},{},{},{:.3f},{:.3f},{:.2f},{:.2f}\n", s.id, s.source, samples, s.faces, rates[i],
+                samples ? static_cast<double>(s.busy_ns) / 1e6 / static_cast<double>(samples) : 0.0,
+                s.estimates ? s.bpm_sum / static_cast<double>(s.estimates) : 0.0, s.last_bpm);
+        }
+    }
+    return 0;
+}